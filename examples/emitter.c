@@ -5,7 +5,9 @@
  * spdx-license-identifer: lgpl-3.0-or-later
  */
 
+#include <errno.h>
 #include <error.h>
+#include <unistd.h>
 
 #include "miniyaml.h"
 
@@ -48,7 +50,9 @@ main()
     if (!yaml_emitter_initialize(&emitter))
         error(EXIT_FAILURE, 0, "yaml_emitter_initialize");
 
-    yaml_emitter_set_output_file(&emitter, stdout);
+    /* Write to stdout in blocks of 1 MiB */
+    if (!yaml_emitter_set_output_fd(&emitter, STDOUT_FILENO, 1 << 20))
+        error(EXIT_FAILURE, errno, "yaml_emitter_set_output_fd");
     yaml_emitter_set_unicode(&emitter, true);
 
     if (!yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING))
@@ -62,6 +66,9 @@ main()
     if (!yaml_emit_stream_end(&emitter))
         emitter_error(&emitter);
 
+    if (!yaml_emitter_unset_output_fd(&emitter))
+        error(EXIT_FAILURE, errno, "write");
+
     yaml_emitter_delete(&emitter);
     return EXIT_SUCCESS;
 }
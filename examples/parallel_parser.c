@@ -0,0 +1,294 @@
+/* this file is part of MiniYAML
+ * copyright (c) 2019 commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * spdx-license-identifer: lgpl-3.0-or-later
+ */
+
+#include <errno.h>
+#include <error.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "miniyaml.h"
+
+#define PERSON_TAG "!person"
+
+struct person {
+    char name[128];
+    uint32_t age;
+};
+
+struct fields_seen {
+    bool name:1;
+    bool age:1;
+};
+
+/* Documents are parsed on several threads: instead of exiting on the first
+ * parser error, the functions below return false, and the earliest document
+ * that failed is kept here.
+ */
+struct failure {
+    pthread_mutex_t lock;
+    /* SIZE_MAX until a document fails */
+    size_t index;
+    const char *problem;
+};
+
+static void
+parser_error(yaml_parser_t *parser, size_t index, struct failure *failure)
+{
+    pthread_mutex_lock(&failure->lock);
+    if (index < failure->index) {
+        failure->index = index;
+        failure->problem = parser->problem;
+    }
+    pthread_mutex_unlock(&failure->lock);
+}
+
+enum person_field {
+    PF_UNKNOWN,
+    PF_NAME,
+    PF_AGE,
+};
+
+static enum person_field __attribute__((pure))
+person_field_tokenize(const char *key)
+{
+    switch (*key++) {
+    case 'a': /* age */
+        if (strcmp(key, "ge"))
+            break;
+        return PF_AGE;
+    case 'n': /* name */
+        if (strcmp(key, "ame"))
+            break;
+        return PF_NAME;
+    }
+
+    return PF_UNKNOWN;
+}
+
+/* Marks are relative to the part of the stream a parser was given, which
+ * may start several documents before @index: errors only name the document.
+ */
+static bool
+parse_person_field(yaml_parser_t *parser, size_t index, struct person *person,
+                   const char *key, struct fields_seen *seen)
+{
+    yaml_event_t event;
+    const char *name;
+    bool success;
+
+    if (!yaml_parser_parse(parser, &event))
+        return false;
+
+    switch (person_field_tokenize(key)) {
+    case PF_UNKNOWN:
+        error(0, 0, "document %zu: unknown mapping key '%s'", index, key);
+        goto skip;
+    case PF_NAME:
+        success = yaml_parse_string(&event, &name, NULL);
+        if (success) {
+            int rc;
+
+            rc = snprintf(person->name, sizeof(person->name), "%s", name);
+            if (rc >= 0 && rc < sizeof(person->name)) {
+                seen->name = true;
+            } else {
+                errno = EOVERFLOW;
+                success = false;
+            }
+        }
+        break;
+    case PF_AGE:
+        success = yaml_parse_uint32(&event, &person->age);
+        if (success)
+            seen->age = true;
+
+    }
+
+    if (!success)
+        error(0, errno, "document %zu: %s", index, key);
+
+skip:
+    /* It is only safe to skip on success because no key should successfully
+     * map to a mapping or a sequence.
+     */
+    success = yaml_parser_skip(parser, event.type);
+    yaml_event_delete(&event);
+    return success;
+}
+
+static bool
+parse_person_mapping(yaml_parser_t *parser, size_t index,
+                     struct person *person, bool *complete)
+{
+    struct fields_seen seen = {};
+    bool end = false;
+
+    do {
+        yaml_event_t event;
+        const char *key;
+        bool success;
+
+        if (!yaml_parser_parse(parser, &event))
+            return false;
+
+        switch (event.type) {
+        case YAML_MAPPING_END_EVENT:
+            end = true;
+            success = true;
+            break;
+        case YAML_SCALAR_EVENT:
+            /* Only keys that are strings are allowed/expected here */
+            if (yaml_parse_string(&event, &key, NULL)) {
+                success = parse_person_field(parser, index, person, key,
+                                             &seen);
+                break;
+            }
+
+            /* Otherwise, skip it */
+            __attribute__((fallthrough));
+        default:
+            /* Ignore this key/value */
+            success = yaml_parser_skip(parser, event.type)
+                   && yaml_parser_skip_next(parser);
+        }
+
+        yaml_event_delete(&event);
+        if (!success)
+            return false;
+    } while (!end);
+
+    *complete = seen.name && seen.age;
+    return true;
+}
+
+static bool
+parse_person_document(yaml_parser_t *parser, size_t index,
+                      struct person *person, bool *valid)
+{
+    yaml_event_t event;
+    const char *tag;
+
+    *valid = false;
+
+    if (!yaml_parser_parse(parser, &event))
+        return false;
+
+    if (event.type != YAML_MAPPING_START_EVENT)
+        goto skip;
+
+    tag = yaml_mapping_tag(&event);
+    if (tag && strcmp(tag, PERSON_TAG))
+        goto skip;
+
+    yaml_event_delete(&event);
+
+    if (!parse_person_mapping(parser, index, person, valid))
+        return false;
+
+    if (tag && !*valid)
+        /* We know for sure this should have been a person mapping */
+        error(0, 0, "document %zu: incomplete person mapping", index);
+
+    if (!yaml_parser_parse(parser, &event))
+        return false;
+    assert(event.type == YAML_DOCUMENT_END_EVENT);
+
+    return true;
+
+skip:
+    yaml_event_delete(&event);
+    return yaml_parser_skip(parser, YAML_DOCUMENT_START_EVENT);
+}
+
+/* Called from several threads at once */
+static void *
+parse_person(yaml_parser_t *parser, size_t index, void *data)
+{
+    struct person *person = malloc(sizeof(*person));
+    bool valid;
+
+    if (person == NULL)
+        error(EXIT_FAILURE, errno, "malloc");
+
+    if (!parse_person_document(parser, index, person, &valid)) {
+        /* yaml_parallel_parse() stops once this returns */
+        parser_error(parser, index, data);
+        valid = false;
+    }
+
+    if (!valid) {
+        free(person);
+        return NULL;
+    }
+
+    return person;
+}
+
+/* Called in the order of documents in the stream */
+static void
+print_person(void *result, size_t index, void *data)
+{
+    struct person *person = result;
+
+    if (person == NULL)
+        return;
+
+    printf("person = {.name = %s, .age = %" PRIu32 "}\n", person->name,
+           person->age);
+    free(person);
+}
+
+static char *
+read_all(FILE *file, size_t *length)
+{
+    size_t capacity = 4096;
+    char *buffer = NULL;
+
+    *length = 0;
+    do {
+        char *tmp;
+
+        capacity *= 2;
+        tmp = realloc(buffer, capacity);
+        if (tmp == NULL)
+            error(EXIT_FAILURE, errno, "realloc");
+        buffer = tmp;
+
+        *length += fread(buffer + *length, 1, capacity - *length, file);
+    } while (*length == capacity);
+
+    if (ferror(file))
+        error(EXIT_FAILURE, 0, "fread");
+
+    return buffer;
+}
+
+int
+main()
+{
+    struct failure failure = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .index = SIZE_MAX,
+    };
+    size_t length;
+    char *input;
+
+    /* Documents are parsed on as many threads as there are CPUs */
+    input = read_all(stdin, &length);
+    if (!yaml_parallel_parse(input, length, 0, true, parse_person,
+                             print_person, &failure)) {
+        if (failure.index == SIZE_MAX)
+            /* Not in the content of a document (eg. in a directive) */
+            error(EXIT_FAILURE, errno, "yaml_parallel_parse");
+
+        error(EXIT_FAILURE, errno, "document %zu: %s", failure.index,
+              failure.problem);
+    }
+
+    free(input);
+    return EXIT_SUCCESS;
+}
@@ -7,7 +7,7 @@
 
 #include <errno.h>
 #include <error.h>
-#include <limits.h>
+#include <inttypes.h>
 
 #include "miniyaml.h"
 
@@ -15,7 +15,7 @@
 
 struct person {
     char name[128];
-    unsigned int age;
+    uint32_t age;
 };
 
 struct fields_seen {
@@ -26,7 +26,8 @@ struct fields_seen {
 static void __attribute__((noreturn))
 parser_error(yaml_parser_t *parser)
 {
-    error(EXIT_FAILURE, 0, "parser error: %s", parser->problem);
+    error(EXIT_FAILURE, 0, "parser error: %s, l.%zu:%zu", parser->problem,
+          parser->problem_mark.line, parser->problem_mark.column);
     __builtin_unreachable();
 }
 
@@ -59,7 +60,6 @@ parse_person_field(yaml_parser_t *parser, struct person *person,
 {
     yaml_event_t event;
     const char *name;
-    intmax_t age;
     bool success;
 
     if (!yaml_parser_parse(parser, &event))
@@ -84,16 +84,9 @@ parse_person_field(yaml_parser_t *parser, struct person *person,
         }
         break;
     case PF_AGE:
-        success = yaml_parse_integer(&event, &age);
-        if (success) {
-            if (age >= 0 && age <= UINT_MAX) {
-                person->age = age;
-                seen->age = true;
-            } else {
-                success = false;
-                errno = ERANGE;
-            }
-        }
+        success = yaml_parse_uint32(&event, &person->age);
+        if (success)
+            seen->age = true;
 
     }
 
@@ -214,8 +207,8 @@ main()
         switch (event.type) {
         case YAML_DOCUMENT_START_EVENT:
             if (parse_person_document(&parser, &person))
-                printf("person = {.name = %s, .age = %d}\n", person.name,
-                       person.age);
+                printf("person = {.name = %s, .age = %" PRIu32 "}\n",
+                       person.name, person.age);
             break;
         case YAML_STREAM_END_EVENT:
             end = true;
@@ -12,6 +12,7 @@
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
 
 #include <sys/types.h>
 
@@ -44,6 +45,27 @@
 bool
 yaml_parser_skip(yaml_parser_t *parser, yaml_event_type_t type);
 
+/**
+ * Skip the rest of a document, without checking it is valid
+ *
+ * @param parser    the parser for which to skip a document; the last event it
+ *                  yielded must be a YAML_DOCUMENT_START_EVENT
+ *
+ * @return          false if there was a parsing error while skipping the
+ *                  document, true otherwise
+ *
+ * Documents that start with an explicit "---" and are read from a string
+ * (yaml_parser_set_input_string()) are skipped without being parsed: only
+ * their lines are scanned for the next document marker. Errors in the
+ * content of such documents go unnoticed.
+ *
+ * This relies on internals of libyaml that were only checked with libyaml
+ * 0.2.5. With any other release, or any other document, this function is
+ * the same as yaml_parser_skip(parser, YAML_DOCUMENT_START_EVENT).
+ */
+bool
+yaml_parser_skip_document_unchecked(yaml_parser_t *parser);
+
 /**
  * Skip the next event or series of event
  *
@@ -69,6 +91,272 @@ yaml_parser_skip_next(yaml_parser_t *parser)
     return success;
 }
 
+/**
+ * The position of a document in a YAML stream
+ */
+struct yaml_document_offset {
+    /** the offset of the first byte of the document in the stream */
+    size_t offset;
+    /** the line of that byte (the first line is 0, as in yaml_mark_t) */
+    size_t line;
+    /** the offset of the tag of the root node, relative to offset */
+    uint32_t tag_offset;
+    /** the length of that tag, 0 if there is none */
+    uint32_t tag_length;
+};
+
+/**
+ * Find where each document of a YAML stream starts
+ *
+ * @param input     a YAML stream in UTF-8
+ * @param length    the length of \p input
+ * @param documents on success, set to an array of the documents in \p input,
+ *                  in order, to be freed with free()
+ * @param count     on success, set to the number of elements in \p documents
+ *
+ * @return          true on success, false otherwise and errno is set
+ *                  appropriately
+ *
+ * @error ENOMEM    there was not enough memory available
+ *
+ * Document i spans from documents[i].offset to documents[i + 1].offset (or
+ * \p length for the last one): each of these slices can be handed to a new
+ * parser on its own. Comments and directives that precede a document are part
+ * of its slice.
+ *
+ * Only the lines of \p input are looked at: the content of documents is not
+ * checked for errors. Root tags are only found on the line of the "---" marker
+ * (eg. "--- !entry"), as they are written (with their handle unresolved).
+ */
+bool
+yaml_index_documents(const char *input, size_t length,
+                     struct yaml_document_offset **documents, size_t *count);
+
+/**
+ * Parse a document of a stream yaml_parallel_parse() is working on
+ *
+ * @param parser    a parser that just yielded the YAML_DOCUMENT_START_EVENT
+ *                  of the document; events must be consumed up to, and
+ *                  including, the matching YAML_DOCUMENT_END_EVENT
+ * @param index     the index of the document in the stream
+ * @param data      the data passed to yaml_parallel_parse()
+ *
+ * @return          anything, it is passed to a yaml_deliver_document_t
+ *
+ * This function is called from several threads at once.
+ */
+typedef void *yaml_parse_document_t(yaml_parser_t *parser, size_t index,
+                                    void *data);
+
+/**
+ * Collect the result of a yaml_parse_document_t
+ *
+ * @param result    what the yaml_parse_document_t returned
+ * @param index     the index of the document in the stream
+ * @param data      the data passed to yaml_parallel_parse()
+ *
+ * Calls to this function never overlap.
+ */
+typedef void yaml_deliver_document_t(void *result, size_t index, void *data);
+
+/**
+ * Parse the documents of a YAML stream on several threads
+ *
+ * @param input     a YAML stream in UTF-8
+ * @param length    the length of \p input
+ * @param threads   the maximum number of threads to use (the calling thread
+ *                  included), 0 for one per online CPU
+ * @param ordered   whether results must be delivered in the order of the
+ *                  documents in \p input
+ * @param parse     the function to parse each document with
+ * @param deliver   the function to collect each result with
+ * @param data      passed as is to \p parse and \p deliver
+ *
+ * @return          true on success, false otherwise and errno is set
+ *                  appropriately
+ *
+ * @error EINVAL    there was a parsing error
+ * @error ENOMEM    there was not enough memory available
+ *
+ * \p input is split into documents with yaml_index_documents(), and groups of
+ * consecutive documents are handed to threads, each with a parser of its own.
+ *
+ * Functions written to parse a document from a sequential parser, right after
+ * its YAML_DOCUMENT_START_EVENT, work unchanged from within \p parse.
+ *
+ * On error, no new document is parsed, but every result that was produced is
+ * still delivered (in order if \p ordered is true, minus the gaps).
+ */
+bool
+yaml_parallel_parse(const char *input, size_t length, unsigned int threads,
+                    bool ordered, yaml_parse_document_t *parse,
+                    yaml_deliver_document_t *deliver, void *data);
+
+/**
+ * Set a parser's input to a file, mapped in memory
+ *
+ * @param parser    the parser to set the input of
+ * @param path      the path of the file to read
+ *
+ * @return          true on success, false otherwise and errno is set
+ *                  appropriately
+ *
+ * @error EISDIR    \p path is a directory
+ * @error EFBIG     \p path is too large to be mapped
+ *
+ * This function may also fail and set errno for any of the errors specified
+ * for open(2), fstat(2), fdopen(3) and mmap(2).
+ *
+ * Unlike yaml_parser_set_input_file(), this saves a copy of the input through
+ * stdio's buffers. Files that cannot be mapped (eg. pipes) are read through
+ * stdio all the same.
+ *
+ * The file must not be truncated while the parser reads it. Once done, call
+ * yaml_parser_unset_input_mmap() before yaml_parser_delete().
+ */
+bool
+yaml_parser_set_input_mmap(yaml_parser_t *parser, const char *path);
+
+/**
+ * Release the input of a parser set with yaml_parser_set_input_mmap()
+ *
+ * @param parser    the parser to release the input of
+ */
+void
+yaml_parser_unset_input_mmap(yaml_parser_t *parser);
+
+/**
+ * Set a parser's input to a file descriptor
+ *
+ * @param parser        the parser to set the input of
+ * @param fd            the file descriptor to read from
+ * @param block_size    how many bytes to read at once (eg. 1 MiB), 0 to read
+ *                      only as much as libyaml asks for
+ *
+ * @return              true on success, false otherwise and errno is set
+ *                      appropriately
+ *
+ * @error ENOMEM        there was not enough memory available
+ *
+ * Unlike yaml_parser_set_input_file(), there is no locking and no stdio
+ * buffer involved. Reads interrupted by a signal are retried. On regular
+ * files, the kernel is told to read ahead of the parser.
+ *
+ * \p fd is not closed by the parser. Once done, call
+ * yaml_parser_unset_input_fd() before yaml_parser_delete().
+ */
+bool
+yaml_parser_set_input_fd(yaml_parser_t *parser, int fd, size_t block_size);
+
+/**
+ * Release the input of a parser set with yaml_parser_set_input_fd()
+ *
+ * @param parser    the parser to release the input of
+ */
+void
+yaml_parser_unset_input_fd(yaml_parser_t *parser);
+
+/*----------------------------------------------------------------------------*
+ |                                  emitter                                   |
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Set an emitter's output to a file descriptor
+ *
+ * @param emitter       the emitter to set the output of
+ * @param fd            the file descriptor to write to
+ * @param block_size    how many bytes to write at once (eg. 1 MiB), 0 to
+ *                      write as soon as libyaml flushes its own buffer
+ *
+ * @return              true on success, false otherwise and errno is set
+ *                      appropriately
+ *
+ * @error ENOMEM        there was not enough memory available
+ *
+ * Unlike yaml_emitter_set_output_file(), there is no locking and no stdio
+ * buffer involved. Interrupted and short writes are resumed.
+ *
+ * Output is kept until \p block_size bytes are buffered, including across
+ * yaml_emitter_flush(). \p fd is not closed by the emitter. Once done, call
+ * yaml_emitter_unset_output_fd() before yaml_emitter_delete().
+ */
+bool
+yaml_emitter_set_output_fd(yaml_emitter_t *emitter, int fd, size_t block_size);
+
+/**
+ * Write what is left of an emitter's output, and release it
+ *
+ * @param emitter   an emitter whose output was set with
+ *                  yaml_emitter_set_output_fd()
+ *
+ * @return          true on success, false otherwise and errno is set
+ *                  appropriately
+ *
+ * This function may fail and set errno for any of the errors specified for
+ * write(2).
+ *
+ * The output is released even on error.
+ */
+bool
+yaml_emitter_unset_output_fd(yaml_emitter_t *emitter);
+
+/*----------------------------------------------------------------------------*
+ |                                    tag                                     |
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Types of the YAML tag repository (https://yaml.org/type/)
+ */
+enum yaml_type {
+    /* Not a type of the YAML tag repository */
+    YT_UNKNOWN = -1,
+
+    /* Collection types */
+    YT_MAP,
+    YT_OMAP,
+    YT_PAIRS,
+    YT_SET,
+    YT_SEQ,
+
+    /* Scalar types */
+    YT_BINARY,
+    YT_BOOL,
+    YT_FLOAT,
+    YT_INT,
+    YT_MERGE,
+    YT_NULL,
+    YT_STR,
+    YT_TIMESTAMP,
+    YT_VALUE,
+    YT_YAML,
+};
+
+/**
+ * Resolve a tag to a type of the YAML tag repository
+ *
+ * @param tag       a tag, either a full tag URI (eg. "tag:yaml.org,2002:int")
+ *                  or in its shorthand notation (eg. "!!int")
+ *
+ * @return          the type \p tag represents on success, YT_UNKNOWN
+ *                  otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p tag belongs to the YAML tag repository, but does not
+ *                  represent any of the types it defines
+ * @error ENOTSUP   \p tag does not belong to the YAML tag repository (eg. it
+ *                  is a local tag such as "!person")
+ */
+enum yaml_type
+yaml_tag2type(const char *tag);
+
+/**
+ * Same as yaml_tag2type(), for a tag that is not null-terminated
+ *
+ * @param tag       a tag
+ * @param length    the number of bytes in \p tag
+ */
+enum yaml_type
+yaml_tag2type_n(const char *tag, size_t length);
+
 /*----------------------------------------------------------------------------*
  |                                   event                                    |
  *----------------------------------------------------------------------------*/
@@ -312,6 +600,49 @@ yaml_scalar_is_plain(const yaml_event_t *event)
     return yaml_scalar_style(event) == YAML_PLAIN_SCALAR_STYLE;
 }
 
+/**
+ * A keyword (at most 8 characters long) and the value it stands for
+ */
+struct yaml_keyword {
+    const char *name;
+    int value;
+};
+
+/**
+ * Match the value of a scalar event against a list of keywords
+ *
+ * @param event     a scalar event
+ * @param keywords  an array of keywords, whose names are at most 8 bytes long
+ * @param count     the number of keywords in \p keywords
+ * @param fold_case whether to ignore case (names in \p keywords must then be
+ *                  in lower case)
+ * @param value     a pointer to an int; on success, it is set to the value of
+ *                  the keyword \p event matches
+ *
+ * @return          true if \p event matches one of \p keywords, false
+ *                  otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event does not match any of \p keywords
+ *
+ * This is useful to parse enum-like fields. Like YAML does for booleans,
+ * ignoring case only allows keywords in lower case (readonly), capitalized
+ * (Readonly) or upper case (READONLY). Neither the tag nor the style of
+ * \p event are checked.
+ *
+ * Keywords longer than 8 bytes never match anything.
+ */
+bool
+yaml_scalar_match(const yaml_event_t *event,
+                  const struct yaml_keyword *keywords, size_t count,
+                  bool fold_case, int *value);
+
+/* Some of the yaml_parse_<type>() functions below have a yaml_parse_<type>_n()
+ * counterpart that parses a scalar which is not a libyaml event (eg. a value
+ * read from a memory-mapped file). The scalar is given as its value, the
+ * number of bytes in that value, its style, and its tag (or NULL). Values do
+ * not need to be null-terminated: they are never read past their length.
+ */
+
 /**
  * Emit a YAML_SCALAR_EVENT
  *
@@ -365,6 +696,13 @@ yaml_emit_null(yaml_emitter_t *emitter)
 bool
 yaml_parse_null(const yaml_event_t *event);
 
+/**
+ * Same as yaml_parse_null(), without an event
+ */
+bool
+yaml_parse_null_n(const char *value, size_t length, yaml_scalar_style_t style,
+                  const char *tag);
+
         /*------------------------------------------------------------*
          |                          boolean                           |
          *------------------------------------------------------------*/
@@ -398,6 +736,13 @@ yaml_emit_boolean(yaml_emitter_t *emitter, bool b)
 bool
 yaml_parse_boolean(const yaml_event_t *event, bool *b);
 
+/**
+ * Same as yaml_parse_boolean(), without an event
+ */
+bool
+yaml_parse_boolean_n(const char *value, size_t length,
+                     yaml_scalar_style_t style, const char *tag, bool *b);
+
         /*------------------------------------------------------------*
          |                      (signed) integer                      |
          *------------------------------------------------------------*/
@@ -410,15 +755,8 @@ yaml_parse_boolean(const yaml_event_t *event, bool *b);
  *
  * @return          true on success, false otherwise
  */
-static inline bool
-yaml_emit_integer(yaml_emitter_t *emitter, intmax_t i)
-{
-    char buffer[sizeof(i) * 4];
-    int n;
-
-    n = snprintf(buffer, sizeof(buffer), "%" PRIiMAX, i);
-    return yaml_emit_scalar(emitter, NULL, buffer, n, YAML_PLAIN_SCALAR_STYLE);
-}
+bool
+yaml_emit_integer(yaml_emitter_t *emitter, intmax_t i);
 
 /**
  * Parse a scalar event as a signed integer
@@ -432,10 +770,21 @@ yaml_emit_integer(yaml_emitter_t *emitter, intmax_t i)
  *
  * @error EINVAL    \p event is not parsable as a signed integer
  * @error ERANGE    the value \p event represents does not fit in an intmaxt_t
+ *
+ * Decimal, hexadecimal ("0x" or "0X"), octal ("0o" or a leading "0") and
+ * binary ("0b") integers are supported, digits may be separated with
+ * underscores (eg. 1_000_000). Parsing does not depend on the current locale.
  */
 bool
 yaml_parse_integer(const yaml_event_t *event, intmax_t *i);
 
+/**
+ * Same as yaml_parse_integer(), without an event
+ */
+bool
+yaml_parse_integer_n(const char *value, size_t length,
+                     yaml_scalar_style_t style, const char *tag, intmax_t *i);
+
         /*------------------------------------------------------------*
          |                      unsigned integer                      |
          *------------------------------------------------------------*/
@@ -448,15 +797,8 @@ yaml_parse_integer(const yaml_event_t *event, intmax_t *i);
  *
  * @return          true on success, false otherwise
  */
-static inline bool
-yaml_emit_unsigned_integer(yaml_emitter_t *emitter, uintmax_t u)
-{
-    char buffer[sizeof(u) * 4];
-    int n;
-
-    n = snprintf(buffer, sizeof(buffer), "%" PRIuMAX, u);
-    return yaml_emit_scalar(emitter, NULL, buffer, n, YAML_PLAIN_SCALAR_STYLE);
-}
+bool
+yaml_emit_unsigned_integer(yaml_emitter_t *emitter, uintmax_t u);
 
 /**
  * Parse a scalar event as an unsigned integer
@@ -476,10 +818,164 @@ yaml_emit_unsigned_integer(yaml_emitter_t *emitter, uintmax_t u)
  * (eg. -UINTMAX_MAX --> 1).
  * Integers strictly smaller than -UINTMAX_MAX will fail to be parsed and errno
  * will be set to ERANGE.
+ *
+ * The same notations as yaml_parse_integer() are supported.
  */
 bool
 yaml_parse_unsigned_integer(const yaml_event_t *event, uintmax_t *u);
 
+/**
+ * Same as yaml_parse_unsigned_integer(), without an event
+ */
+bool
+yaml_parse_unsigned_integer_n(const char *value, size_t length,
+                              yaml_scalar_style_t style, const char *tag,
+                              uintmax_t *u);
+
+        /*------------------------------------------------------------*
+         |                    fixed-width integers                    |
+         *------------------------------------------------------------*/
+
+/**
+ * Parse a scalar event as a signed integer of a given width
+ *
+ * @param event     a scalar event
+ * @param i         a pointer to an int8_t, int16_t, int32_t or int64_t; on
+ *                  success, it is set to the value \p event represents
+ *
+ * @return          true if \p event was successfully parsed as a signed
+ *                  integer, false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as a signed integer
+ * @error ERANGE    the value \p event represents does not fit in \p *i
+ *
+ * The same notations as yaml_parse_integer() are supported.
+ */
+bool
+yaml_parse_int8(const yaml_event_t *event, int8_t *i);
+
+bool
+yaml_parse_int16(const yaml_event_t *event, int16_t *i);
+
+bool
+yaml_parse_int32(const yaml_event_t *event, int32_t *i);
+
+bool
+yaml_parse_int64(const yaml_event_t *event, int64_t *i);
+
+/**
+ * Parse a scalar event as an unsigned integer of a given width
+ *
+ * @param event     a scalar event
+ * @param u         a pointer to an uint8_t, uint16_t, uint32_t or uint64_t; on
+ *                  success, it is set to the value \p event represents
+ *
+ * @return          true if \p event was successfully parsed as an unsigned
+ *                  integer, false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as an unsigned integer
+ * @error ERANGE    the value \p event represents does not fit in \p *u
+ *
+ * Unlike yaml_parse_unsigned_integer(), negative integers (other than zero)
+ * are out of range.
+ *
+ * The same notations as yaml_parse_integer() are supported.
+ */
+bool
+yaml_parse_uint8(const yaml_event_t *event, uint8_t *u);
+
+bool
+yaml_parse_uint16(const yaml_event_t *event, uint16_t *u);
+
+bool
+yaml_parse_uint32(const yaml_event_t *event, uint32_t *u);
+
+bool
+yaml_parse_uint64(const yaml_event_t *event, uint64_t *u);
+
+        /*------------------------------------------------------------*
+         |                           float                            |
+         *------------------------------------------------------------*/
+
+/**
+ * Emit a float
+ *
+ * @param emitter   the emitter to use
+ * @param d         the float to emit
+ *
+ * @return          true on success, false otherwise
+ *
+ * \p d is emitted with the fewest digits that parse back to the exact same
+ * double (eg. 0.1, 1.0e+100). Infinities are emitted as ".inf" and "-.inf",
+ * NaNs as ".nan". The output does not depend on the current locale.
+ */
+bool
+yaml_emit_float(yaml_emitter_t *emitter, double d);
+
+/**
+ * Parse a scalar event as a float
+ *
+ * @param event     a scalar event
+ * @param d         a pointer to a double; on success, it is set to the value
+ *                  \p event represents (rounded to nearest)
+ *
+ * @return          true if \p event was successfully parsed as a float, false
+ *                  otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as a float
+ * @error ERANGE    the value \p event represents is too large (or too small)
+ *                  to be represented as a (non-zero) double
+ *
+ * Decimal (eg. 1.5, -2e-3, 1_000.0) and special (.inf, -.Inf, .NaN, ...)
+ * notations are supported. Parsing does not depend on the current locale.
+ */
+bool
+yaml_parse_float(const yaml_event_t *event, double *d);
+
+        /*------------------------------------------------------------*
+         |                         timestamp                          |
+         *------------------------------------------------------------*/
+
+/**
+ * Emit a timestamp
+ *
+ * @param emitter   the emitter to use
+ * @param ts        the timestamp to emit
+ *
+ * @return          true on success, false otherwise and errno is set
+ *                  appropriately
+ *
+ * @error EINVAL    \p ts's tv_nsec is not in [0, 999999999]
+ * @error ERANGE    \p ts is before year 0 or after year 9999
+ *
+ * \p ts is emitted in UTC, as "YYYY-MM-DDTHH:MM:SSZ" or, if it has a
+ * fractional part, as "YYYY-MM-DDTHH:MM:SS.fffffffffZ".
+ */
+bool
+yaml_emit_timestamp(yaml_emitter_t *emitter, struct timespec ts);
+
+/**
+ * Parse a scalar event as a timestamp
+ *
+ * @param event     a scalar event
+ * @param ts        a pointer to a struct timespec; on success, it is set to
+ *                  the point in time \p event represents
+ *
+ * @return          true if \p event was successfully parsed as a timestamp,
+ *                  false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as a timestamp
+ * @error ERANGE    the point in time \p event represents cannot be
+ *                  represented as a time_t
+ *
+ * Every notation of the YAML timestamp type is supported (eg. 2001-12-14,
+ * 2001-12-14t21:59:43.10-05:00, 2001-12-14 21:59:43.10 -5). Timestamps
+ * without a time zone are in UTC. Fractions of a second beyond the nanosecond
+ * are truncated.
+ */
+bool
+yaml_parse_timestamp(const yaml_event_t *event, struct timespec *ts);
+
         /*------------------------------------------------------------*
          |                           string                           |
          *------------------------------------------------------------*/
@@ -525,6 +1021,17 @@ bool
 yaml_parse_string(const yaml_event_t *event, const char **string,
                   size_t *length);
 
+/**
+ * Same as yaml_parse_string(), without an event
+ *
+ * \p string is set to \p value, and \p string_length (if not NULL) to
+ * \p length.
+ */
+bool
+yaml_parse_string_n(const char *value, size_t length,
+                    yaml_scalar_style_t style, const char *tag,
+                    const char **string, size_t *string_length);
+
         /*------------------------------------------------------------*
          |                           binary                           |
          *------------------------------------------------------------*/
@@ -541,6 +1048,73 @@ yaml_parse_string(const yaml_event_t *event, const char **string,
 bool
 yaml_emit_binary(yaml_emitter_t *emitter, const char *data, size_t size);
 
+/**
+ * A growable buffer that can be reused from one call to the next
+ *
+ * Zero-initialize it before its first use (eg. `yaml_scratch_t scratch = {};`)
+ * and release it with yaml_scratch_delete(). A scratch buffer must not be used
+ * by multiple threads at once, use one per thread instead.
+ */
+typedef struct yaml_scratch {
+    char *data;
+    size_t size;
+} yaml_scratch_t;
+
+/**
+ * Release the memory held by a scratch buffer
+ *
+ * @param scratch   the scratch buffer to release
+ *
+ * \p scratch can be reused afterwards, as if it was just zero-initialized.
+ */
+void
+yaml_scratch_delete(yaml_scratch_t *scratch);
+
+/**
+ * Emit binary data, using a caller-provided scratch buffer
+ *
+ * @param emitter   the emitter to use
+ * @param data      the binary data to emit
+ * @param size      the number of bytes in \p data to emit
+ * @param scratch   a scratch buffer to encode \p data into
+ *
+ * @return          true on success, false otherwise
+ *
+ * Same as yaml_emit_binary(), except \p data is encoded in \p scratch, which
+ * only grows when it is too small for \p data. Once \p scratch is big enough,
+ * this function does not allocate any memory itself (libyaml still copies the
+ * encoded data into the event it emits).
+ */
+bool
+yaml_emit_binary_scratch(yaml_emitter_t *emitter, const char *data,
+                         size_t size, yaml_scratch_t *scratch);
+
+/**
+ * Emit binary data as a literal block scalar, without buffering it
+ *
+ * @param emitter   the emitter to use
+ * @param data      the binary data to emit
+ * @param size      the number of bytes in \p data to emit
+ *
+ * @return          true on success, false otherwise
+ *
+ * \p data is encoded and written to the emitter's output handler in lines of
+ * 76 characters, a few kilobytes at a time. Memory usage does not depend on
+ * \p size.
+ *
+ * Block scalars are not always possible: in flow context, in canonical mode,
+ * or when the output is not UTF-8 encoded, this function behaves like
+ * yaml_emit_binary().
+ *
+ * Every event emitted before this function is called is written to the output
+ * handler as well (as if yaml_emitter_flush() was called).
+ *
+ * This function relies on the internals of libyaml's emitter, as found in
+ * libyaml 0.2.5.
+ */
+bool
+yaml_emit_binary_stream(yaml_emitter_t *emitter, const char *data, size_t size);
+
 /**
  * Parse a scalar event as binary data
  *
@@ -558,9 +1132,333 @@ yaml_emit_binary(yaml_emitter_t *emitter, const char *data, size_t size);
  *
  * Binary data in yaml is encoded into Base64. The number of bytes \p event may
  * represent is capped by: L * 4 / 3, where L is the length of \p event itself
- * (as returned by yaml_scalar_length()).
+ * (as returned by yaml_scalar_length()). Use yaml_parse_binary_size() for the
+ * exact number.
  */
 bool
 yaml_parse_binary(const yaml_event_t *event, char *data, size_t *size);
 
+/**
+ * Same as yaml_parse_binary(), without an event
+ */
+bool
+yaml_parse_binary_n(const char *value, size_t length,
+                    yaml_scalar_style_t style, const char *tag, char *data,
+                    size_t *size);
+
+/**
+ * Parse a scalar event as strictly encoded binary data
+ *
+ * @param event     a scalar event
+ * @param data      a pointer to a buffer big enough to store the binary data
+ *                  \p event represents; on success, it is filled with this data
+ *
+ * @return          true if \p event was successfully parsed as binary data,
+ *                  false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as binary data
+ * @error EILSEQ    the binary data in \p event is incorrectly encoded, or its
+ *                  padding does not complete the last Base64 quantum exactly
+ *                  (eg. "AA=" or "AA===")
+ *
+ * Same as yaml_parse_binary(), except extraneous padding is rejected rather
+ * than ignored. Padding may still be omitted altogether.
+ */
+bool
+yaml_parse_binary_strict(const yaml_event_t *event, char *data, size_t *size);
+
+/**
+ * Compute the size of the binary data a scalar event represents
+ *
+ * @param event     a scalar event
+ * @param size      on success, set to the number of bytes yaml_parse_binary()
+ *                  would write
+ *
+ * @return          true if \p event looks like binary data, false otherwise and
+ *                  errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as binary data
+ * @error EILSEQ    the binary data in \p event is incorrectly encoded
+ *
+ * This function only counts Base64 characters, it is much faster than actually
+ * decoding \p event. It does not catch every encoding error (misplaced padding
+ * characters for instance) that yaml_parse_binary() does.
+ */
+bool
+yaml_parse_binary_size(const yaml_event_t *event, size_t *size);
+
+/**
+ * Parse a scalar event as binary data, into a buffer of limited size
+ *
+ * @param event     a scalar event
+ * @param data      a buffer of \p capacity bytes; on success, it is filled with
+ *                  the binary data \p event represents
+ * @param capacity  the size of \p data
+ * @param size      on success, set to the number of bytes written to \p data
+ *
+ * @return          true if \p event was successfully parsed as binary data,
+ *                  false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as binary data
+ * @error EILSEQ    the binary data in \p event is incorrectly encoded
+ * @error ENOBUFS   \p data is too small for the binary data in \p event
+ *
+ * Nothing is ever written past \p capacity bytes. On error, the content of
+ * \p data is undefined.
+ */
+bool
+yaml_parse_binary_bounded(const yaml_event_t *event, char *data,
+                          size_t capacity, size_t *size);
+
+/**
+ * Same as yaml_parse_binary_bounded(), without an event
+ */
+bool
+yaml_parse_binary_bounded_n(const char *value, size_t length,
+                            yaml_scalar_style_t style, const char *tag,
+                            char *data, size_t capacity, size_t *size);
+
+/**
+ * Parse a scalar event as binary data, in place
+ *
+ * @param event     a scalar event
+ * @param data      on success, set to the binary data \p event represents
+ * @param size      on success, set to the number of bytes in \p data
+ *
+ * @return          true if \p event was successfully parsed as binary data,
+ *                  false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is not parsable as binary data
+ * @error EILSEQ    the binary data in \p event is incorrectly encoded
+ *
+ * Binary data is always shorter than its Base64 encoding: it is decoded over
+ * the value of \p event itself, and \p data points inside \p event. It remains
+ * valid until \p event is deleted.
+ *
+ * Unless this function fails with EINVAL, the value of \p event is overwritten
+ * (even if it fails): \p event must not be parsed again.
+ */
+bool
+yaml_parse_binary_inplace(yaml_event_t *event, char **data, size_t *size);
+
+        /*------------------------------------------------------------*
+         |                        hexadecimal                         |
+         *------------------------------------------------------------*/
+
+/**
+ * The tag of hexadecimal data emitted without a tag of its own
+ */
+#define YAML_HEX_TAG "!hex"
+
+/**
+ * Emit binary data in hexadecimal
+ *
+ * @param emitter   the emitter to use
+ * @param tag       the tag to use, NULL for YAML_HEX_TAG
+ * @param data      the binary data to emit
+ * @param size      the number of bytes in \p data to emit
+ *
+ * @return          true on success, false otherwise
+ *
+ * Digits are in lower case. This is meant for identifiers (hashes, UUIDs,
+ * ...) which are more readable in hexadecimal than in Base64.
+ *
+ * The scalar is always tagged: without a tag, identifiers that happen to be
+ * made of decimal digits (eg. 0012, or 10e5) would be resolved as numbers.
+ */
+bool
+yaml_emit_hex(yaml_emitter_t *emitter, const char *tag, const char *data,
+              size_t size);
+
+/**
+ * Parse a scalar event as binary data in hexadecimal
+ *
+ * @param event     a scalar event
+ * @param tag       the tag \p event may have, NULL for YAML_HEX_TAG
+ * @param data      a pointer to a buffer of at least \p capacity bytes; on
+ *                  success, it is filled with the binary data \p event
+ *                  represents
+ * @param capacity  the number of bytes \p data can hold
+ * @param size      on success, set to the number of bytes written to \p data
+ *
+ * @return          true if \p event was successfully parsed as binary data,
+ *                  false otherwise and errno is set appropriately
+ *
+ * @error EINVAL    \p event is neither a plain scalar without a tag nor
+ *                  tagged with \p tag
+ * @error EILSEQ    \p event is not made of pairs of hexadecimal digits
+ * @error ENOBUFS   \p data is too small for the binary data in \p event
+ *
+ * Digits may be in either case. On error, the content of \p data is
+ * undefined.
+ */
+bool
+yaml_parse_hex(const yaml_event_t *event, const char *tag, char *data,
+               size_t capacity, size_t *size);
+
+/**
+ * Same as yaml_emit_hex(), for 16-byte (eg. UUIDs, Lustre FIDs), 20-byte
+ * (eg. SHA-1) and 32-byte (eg. SHA-256) identifiers
+ */
+bool
+yaml_emit_hex_16(yaml_emitter_t *emitter, const char *tag,
+                 const char data[16]);
+
+bool
+yaml_emit_hex_20(yaml_emitter_t *emitter, const char *tag,
+                 const char data[20]);
+
+bool
+yaml_emit_hex_32(yaml_emitter_t *emitter, const char *tag,
+                 const char data[32]);
+
+/**
+ * Same as yaml_parse_hex(), for 16-byte, 20-byte and 32-byte identifiers
+ *
+ * @error EINVAL    \p event does not represent exactly 16 (or 20, or 32) bytes
+ */
+bool
+yaml_parse_hex_16(const yaml_event_t *event, const char *tag, char data[16]);
+
+bool
+yaml_parse_hex_20(const yaml_event_t *event, const char *tag, char data[20]);
+
+bool
+yaml_parse_hex_32(const yaml_event_t *event, const char *tag, char data[32]);
+
+        /*------------------------------------------------------------*
+         |                         any scalar                         |
+         *------------------------------------------------------------*/
+
+/**
+ * Schemas plain scalars can be resolved with
+ */
+enum yaml_schema {
+    /* YAML 1.1 types (https://yaml.org/type/) */
+    YAML_SCHEMA_1_1,
+    /* YAML 1.2 core schema */
+    YAML_SCHEMA_CORE,
+};
+
+/**
+ * A scalar and the value it represents
+ */
+struct yaml_scalar {
+    /* YT_NULL, YT_BOOL, YT_INT, YT_FLOAT, YT_TIMESTAMP or YT_STR */
+    enum yaml_type type;
+    /* The member that matches type (value.string for YT_STR), if any; the
+     * union is named so that this header remains valid C99
+     */
+    union {
+        bool b;
+        intmax_t i;
+        double d;
+        struct timespec ts;
+        struct {
+            const char *value;
+            size_t length;
+        } string;
+    } value;
+};
+
+/**
+ * Parse a scalar event, whatever its type
+ *
+ * @param event     a scalar event
+ * @param schema    the schema to resolve plain scalars with
+ * @param scalar    a pointer to a struct yaml_scalar; on success, it is set to
+ *                  the type and value \p event represents
+ *
+ * @return          true if \p event was successfully parsed, false otherwise
+ *                  and errno is set appropriately
+ *
+ * @error EINVAL    \p event's tag does not match its value (eg. "!!int foo")
+ * @error ENOTSUP   \p event is tagged with a local tag, or with a type this
+ *                  function does not handle (eg. !!binary)
+ * @error ERANGE    \p event is an integer that does not fit in an intmax_t, or
+ *                  a float that does not fit in a double
+ *
+ * The type of plain scalars without a tag is inferred from their value, in a
+ * single pass: null, boolean, integer, float, timestamp (YAML 1.1 only), and
+ * string as a last resort. Other scalars are parsed according to their tag,
+ * or as strings if they have none. In the core schema, integers tagged with
+ * "!!int" follow the same rules as plain ones (eg. "!!int 012" is 12).
+ *
+ * Sexagesimal numbers of YAML 1.1 (eg. 1:20:30) are parsed as strings.
+ *
+ * Strings point inside \p event: they remain valid until \p event is
+ * deleted.
+ */
+bool
+yaml_parse_scalar_auto(const yaml_event_t *event, enum yaml_schema schema,
+                       struct yaml_scalar *scalar);
+
+/*----------------------------------------------------------------------------*
+ |                                   base64                                   |
+ *----------------------------------------------------------------------------*/
+
+/**
+ * State of an incremental Base64 decoder
+ *
+ * Its fields are private, use the base64_decoder_*() functions below.
+ */
+typedef struct base64_decoder {
+    unsigned char quantum[4];
+    unsigned char count;
+    unsigned char padding;
+    unsigned char state;
+    bool strict;
+} base64_decoder_t;
+
+/**
+ * Initialize an incremental Base64 decoder
+ *
+ * @param decoder   the decoder to initialize
+ * @param strict    whether padding must complete the last quantum exactly (as
+ *                  with yaml_parse_binary_strict()) or not
+ *
+ * A decoder does not own any resource, there is no need to release it.
+ */
+void
+base64_decoder_init(base64_decoder_t *decoder, bool strict);
+
+/**
+ * Decode a chunk of Base64 encoded data
+ *
+ * @param decoder   an initialized decoder
+ * @param dest      a buffer of at least (n + 3) / 4 * 3 bytes
+ * @param src       the next \p n characters of encoded data
+ * @param n         the number of characters in \p src
+ *
+ * @return          the number of bytes written to \p dest on success, -1 on
+ *                  error and errno is set appropriately
+ *
+ * @error EILSEQ    the data fed to \p decoder so far is incorrectly encoded
+ *
+ * Encoded data may be split anywhere, including in the middle of a quantum or
+ * of a run of whitespace. Characters that do not complete a quantum are kept in
+ * \p decoder until the next call to base64_decoder_update() or
+ * base64_decoder_finish().
+ *
+ * Once this function fails, every subsequent call on \p decoder fails as well.
+ */
+ssize_t
+base64_decoder_update(base64_decoder_t *decoder, char *dest, const char *src,
+                      size_t n);
+
+/**
+ * Decode the last (incomplete) quantum fed to a decoder
+ *
+ * @param decoder   an initialized decoder
+ * @param dest      a buffer of at least 2 bytes
+ *
+ * @return          the number of bytes written to \p dest on success, -1 on
+ *                  error and errno is set appropriately
+ *
+ * @error EILSEQ    the data fed to \p decoder is incorrectly encoded (eg. it
+ *                  ends with a single Base64 character)
+ */
+ssize_t
+base64_decoder_finish(base64_decoder_t *decoder, char *dest);
+
 #endif
@@ -6,7 +6,6 @@
  */
 
 #include <assert.h>
-#include <ctype.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -15,6 +14,9 @@
 
 #include <sys/types.h>
 
+#include "base64.h"
+#include "miniyaml.h"
+
 /* Base64 encoding/decoding implementation following RFC4648 */
 
 static const char table[64] = {
@@ -28,8 +30,12 @@ static const char table[64] = {
     '4', '5', '6', '7', '8', '9', '+', '/',
 };
 
+/*----------------------------------------------------------------------------*
+ |                                  encoding                                  |
+ *----------------------------------------------------------------------------*/
+
 size_t
-base64_encode(char *dest, const char *src, size_t n)
+base64_encode_scalar(char *dest, const char *src, size_t n)
 {
     const uint8_t *data = (const unsigned char *)src;
     size_t i, j = 0;
@@ -62,96 +68,467 @@ base64_encode(char *dest, const char *src, size_t n)
     return j;
 }
 
-static int_fast8_t __attribute__((const))
-indexof(char c)
-{
-    switch (c) {
-    case 'A' ... 'Z':
-        return c - 'A';
-    case 'a' ... 'z':
-        return c - 'a' + 26;
-    case '0' ... '9':
-        return c - '0' + 52;
-    case '+':
-        return 62;
-    case '/':
-        return 63;
+/*----------------------------------------------------------------------------*
+ |                                  decoding                                  |
+ *----------------------------------------------------------------------------*/
+
+/* Each character maps to either its 6-bit value or a combination of the flags
+ * below. Whitespace is the one of the "C" locale, whatever the current locale.
+ */
+#define WS  0x40
+#define PAD 0x80
+#define BAD 0xff
+
+static const uint8_t DECODING_TABLE[256] = {
+    [0 ... 255] = BAD,
+    [' '] = WS, ['\t'] = WS, ['\n'] = WS, ['\v'] = WS, ['\f'] = WS, ['\r'] = WS,
+    ['='] = PAD,
+    ['A'] =  0, ['B'] =  1, ['C'] =  2, ['D'] =  3,
+    ['E'] =  4, ['F'] =  5, ['G'] =  6, ['H'] =  7,
+    ['I'] =  8, ['J'] =  9, ['K'] = 10, ['L'] = 11,
+    ['M'] = 12, ['N'] = 13, ['O'] = 14, ['P'] = 15,
+    ['Q'] = 16, ['R'] = 17, ['S'] = 18, ['T'] = 19,
+    ['U'] = 20, ['V'] = 21, ['W'] = 22, ['X'] = 23,
+    ['Y'] = 24, ['Z'] = 25, ['a'] = 26, ['b'] = 27,
+    ['c'] = 28, ['d'] = 29, ['e'] = 30, ['f'] = 31,
+    ['g'] = 32, ['h'] = 33, ['i'] = 34, ['j'] = 35,
+    ['k'] = 36, ['l'] = 37, ['m'] = 38, ['n'] = 39,
+    ['o'] = 40, ['p'] = 41, ['q'] = 42, ['r'] = 43,
+    ['s'] = 44, ['t'] = 45, ['u'] = 46, ['v'] = 47,
+    ['w'] = 48, ['x'] = 49, ['y'] = 50, ['z'] = 51,
+    ['0'] = 52, ['1'] = 53, ['2'] = 54, ['3'] = 55,
+    ['4'] = 56, ['5'] = 57, ['6'] = 58, ['7'] = 59,
+    ['8'] = 60, ['9'] = 61, ['+'] = 62, ['/'] = 63,
+};
+
+size_t
+base64_decode_blocks_scalar(char *dest, const char **src, const char *end)
+{
+    const uint8_t *input = (const uint8_t *)*src;
+    uint8_t *data = (uint8_t *)dest;
+
+    while ((const char *)input + 4 <= end) {
+        uint8_t a = DECODING_TABLE[input[0]];
+        uint8_t b = DECODING_TABLE[input[1]];
+        uint8_t c = DECODING_TABLE[input[2]];
+        uint8_t d = DECODING_TABLE[input[3]];
+
+        if ((a | b | c | d) & ~0x3f)
+            break;
+
+        data[0] = a << 2 | b >> 4;
+        data[1] = b << 4 | c >> 2;
+        data[2] = c << 6 | d;
+        data += 3;
+        input += 4;
     }
 
-    errno = EINVAL;
-    return -1;
+    *src = (const char *)input;
+    return data - (uint8_t *)dest;
 }
 
+    /*--------------------------------------------------------------------*
+     |                          base64_decoder_t                          |
+     *--------------------------------------------------------------------*/
+
 /* Whitespace characters are ignored. The encoded data may be padded with any
- * number of '=' characters (but only after the encoded data).
+ * number of '=' characters (but only after the encoded data, and without any
+ * whitespace in between).
+ *
+ * In strict mode, padding (if any) must complete the last quantum exactly.
  *
- * XXX: it might be better to treat extranous padding characters as errors
+ * Codecs decode whole quanta in bulk, the decoder only processes characters one
+ * at a time to complete a quantum split across chunks (or by whitespace), and
+ * to handle padding.
  */
 
+enum decoder_state {
+    DS_DATA,
+    DS_PADDING,
+    DS_TRAILING,
+    DS_ERROR,
+};
+
+void
+base64_decoder_init(base64_decoder_t *decoder, bool strict)
+{
+    *decoder = (base64_decoder_t){
+        .state = DS_DATA,
+        .strict = strict,
+    };
+}
+
+static inline bool
+decoder_push(base64_decoder_t *decoder, uint8_t **data, uint8_t c)
+{
+    uint8_t value = DECODING_TABLE[c];
+    uint8_t *quantum = decoder->quantum;
+
+    switch (decoder->state) {
+    case DS_DATA:
+        if (value == WS)
+            return true;
+
+        if (value == PAD) {
+            /* Padding can only complete a quantum of 2 or 3 characters */
+            if (decoder->count < 2)
+                return false;
+            decoder->state = DS_PADDING;
+            decoder->padding = 1;
+            return true;
+        }
+
+        if (value == BAD)
+            return false;
+
+        quantum[decoder->count++] = value;
+        if (decoder->count < 4)
+            return true;
+
+        (*data)[0] = quantum[0] << 2 | quantum[1] >> 4;
+        (*data)[1] = quantum[1] << 4 | quantum[2] >> 2;
+        (*data)[2] = quantum[2] << 6 | quantum[3];
+        *data += 3;
+        decoder->count = 0;
+        return true;
+    case DS_PADDING:
+        if (value == PAD) {
+            /* Saturate, strict mode only accepts up to 2 '=' anyway */
+            if (decoder->padding < 4)
+                decoder->padding++;
+            return true;
+        }
+        if (value != WS)
+            return false;
+        decoder->state = DS_TRAILING;
+        return true;
+    case DS_TRAILING:
+        return value == WS;
+    default:
+        return false;
+    }
+}
+
 ssize_t
-base64_decode(char *dest, const char *src, size_t n)
+base64_decoder_update_codec(base64_decoder_t *decoder,
+                            const struct base64_codec *codec, char *dest,
+                            const char *src, size_t n)
 {
     const char *end = src + n;
     uint8_t *data = (uint8_t *)dest;
-    size_t i = 0;
 
-    while (true) {
-        const char *previous;
+    if (decoder->state == DS_ERROR)
+        goto out_eilseq;
 
-        while (src < end && isspace(*src))
-            src++;
+    while (src < end) {
+        if (decoder->state == DS_DATA && decoder->count == 0) {
+            data += codec->decode_blocks((char *)data, &src, end);
+            if (src == end)
+                break;
+        }
 
-        if (src == end)
-            return i;
-        if (indexof(*src) < 0)
+        if (!decoder_push(decoder, &data, *src++))
             goto out_eilseq;
+    }
 
-        data[i] = indexof(*src++) << 2;
+    return (char *)data - dest;
 
-        while (src < end && isspace(*src))
-            src++;
+out_eilseq:
+    decoder->state = DS_ERROR;
+    errno = EILSEQ;
+    return -1;
+}
+
+ssize_t
+base64_decoder_finish(base64_decoder_t *decoder, char *dest)
+{
+    const uint8_t *quantum = decoder->quantum;
+    uint8_t *data = (uint8_t *)dest;
 
-        if (src == end || indexof(*src) < 0)
+    switch (decoder->state) {
+    case DS_DATA:
+        break;
+    case DS_PADDING:
+    case DS_TRAILING:
+        if (decoder->strict && decoder->padding != 4 - decoder->count)
             goto out_eilseq;
+        break;
+    default:
+        goto out_eilseq;
+    }
 
-        data[i++] |= indexof(*src) >> 4;
-        previous = src++;
+    switch (decoder->count) {
+    case 0:
+        return 0;
+    case 1:
+        goto out_eilseq;
+    case 3:
+        data[1] = quantum[1] << 4 | quantum[2] >> 2;
+        __attribute__((fallthrough));
+    case 2:
+        data[0] = quantum[0] << 2 | quantum[1] >> 4;
+    }
 
-        while (src < end && isspace(*src))
-            src++;
+    return decoder->count - 1;
 
-        if (src == end)
-            return i;
-        if (indexof(*src) < 0) {
-            if (*src == '=')
-                break;
-            goto out_eilseq;
+out_eilseq:
+    decoder->state = DS_ERROR;
+    errno = EILSEQ;
+    return -1;
+}
+
+ssize_t
+base64_decode_codec(const struct base64_codec *codec, char *dest,
+                    const char *src, size_t n, enum base64_flags flags)
+{
+    base64_decoder_t decoder;
+    ssize_t head, tail;
+
+    base64_decoder_init(&decoder, flags & BASE64_STRICT);
+
+    head = base64_decoder_update_codec(&decoder, codec, dest, src, n);
+    if (head < 0)
+        return -1;
+
+    tail = base64_decoder_finish(&decoder, dest + head);
+    if (tail < 0)
+        return -1;
+
+    return head + tail;
+}
+
+/* Decode \p src into a buffer of \p capacity bytes, in a single pass
+ *
+ * Input is fed to the decoder in chunks that cannot produce more bytes than
+ * there is room left in \p dest. Once there is almost no room left, the
+ * decoder writes into a local buffer, and as much as fits is copied to \p dest.
+ */
+static ssize_t
+decode_bounded(const struct base64_codec *codec, char *dest, size_t capacity,
+               const char *src, size_t n)
+{
+    base64_decoder_t decoder;
+    char overflow[48];
+    size_t written = 0;
+    ssize_t rc;
+
+    base64_decoder_init(&decoder, false);
+
+    while (n) {
+        size_t room = capacity - written;
+        /* Updates write at most (k + 3) / 4 * 3 bytes */
+        size_t k = room / 3 * 4;
+
+        if (k) {
+            if (k > n)
+                k = n;
+            rc = base64_decoder_update_codec(&decoder, codec, dest + written,
+                                             src, k);
+        } else {
+            k = n < sizeof(overflow) / 3 * 4 - 3 ? n
+                                                 : sizeof(overflow) / 3 * 4 - 3;
+            rc = base64_decoder_update_codec(&decoder, codec, overflow, src,
+                                             k);
+            if (rc > 0 && (size_t)rc > room)
+                goto out_enobufs;
+            if (rc > 0)
+                memcpy(dest + written, overflow, rc);
         }
+        if (rc < 0)
+            return -1;
+
+        written += rc;
+        src += k;
+        n -= k;
+    }
+
+    rc = base64_decoder_finish(&decoder, overflow);
+    if (rc < 0)
+        return -1;
+    if ((size_t)rc > capacity - written)
+        goto out_enobufs;
+    memcpy(dest + written, overflow, rc);
+
+    return written + rc;
+
+out_enobufs:
+    errno = ENOBUFS;
+    return -1;
+}
 
-        data[i++] = indexof(*previous) << 4 | indexof(*src) >> 2;
-        previous = src++;
+    /*--------------------------------------------------------------------*
+     |                            decoded size                            |
+     *--------------------------------------------------------------------*/
 
-        while (src < end && isspace(*src))
-            src++;
+size_t
+base64_count_scalar(const char **src, const char *end)
+{
+    const uint8_t *input = (const uint8_t *)*src;
+    size_t count = 0;
 
-        if (src == end)
+    for (; input < (const uint8_t *)end; input++) {
+        uint8_t value = DECODING_TABLE[*input];
+
+        /* Padding or garbage */
+        if (value & PAD)
             break;
-        if (indexof(*src) < 0) {
-            if (*src == '=')
-                break;
+        count += value != WS;
+    }
+
+    *src = (const char *)input;
+    return count;
+}
+
+/* Only the characters are checked, not the padding's exact position */
+static ssize_t
+decoded_size(const struct base64_codec *codec, const char *src, size_t n)
+{
+    const char *end = src + n;
+    size_t count = codec->count(&src, end);
+    bool padded = false;
+
+    for (; src < end; src++) {
+        switch (DECODING_TABLE[(uint8_t)*src]) {
+        case WS:
+            break;
+        case PAD:
+            padded = true;
+            break;
+        case BAD:
             goto out_eilseq;
+        default:
+            if (padded)
+                goto out_eilseq;
+            count++;
         }
-        data[i++] = indexof(*previous) << 6 | indexof(*src++);
     }
 
-    while (src < end && *src == '=')
-        src++;
-    while (src < end && isspace(*src))
-        src++;
-    if (src == end)
-        return i;
+    if (count % 4 == 1)
+        goto out_eilseq;
+
+    return count / 4 * 3 + (count % 4 ? count % 4 - 1 : 0);
 
 out_eilseq:
     errno = EILSEQ;
     return -1;
 }
+
+/*----------------------------------------------------------------------------*
+ |                                   codecs                                   |
+ *----------------------------------------------------------------------------*/
+
+static bool
+always(void)
+{
+    return true;
+}
+
+#ifdef BASE64_X86
+static bool
+has_sse41(void)
+{
+    return __builtin_cpu_supports("sse4.1");
+}
+
+static bool
+has_avx2(void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+static bool
+has_avx512vbmi(void)
+{
+    return __builtin_cpu_supports("avx512vbmi")
+        && __builtin_cpu_supports("avx512bw");
+}
+#endif
+
+const struct base64_codec BASE64_CODECS[] = {
+    {
+        .name = "scalar",
+        .supported = always,
+        .encode = base64_encode_scalar,
+        .decode_blocks = base64_decode_blocks_scalar,
+        .count = base64_count_scalar,
+    },
+#ifdef BASE64_X86
+    {
+        .name = "sse4.1",
+        .supported = has_sse41,
+        .encode = base64_encode_sse41,
+        .decode_blocks = base64_decode_blocks_sse41,
+        .count = base64_count_sse41,
+    },
+    {
+        .name = "avx2",
+        .supported = has_avx2,
+        .encode = base64_encode_avx2,
+        .decode_blocks = base64_decode_blocks_avx2,
+        .count = base64_count_avx2,
+    },
+    {
+        .name = "avx512vbmi",
+        .supported = has_avx512vbmi,
+        .encode = base64_encode_avx512vbmi,
+        /* There is no AVX-512 decoder (yet) */
+        .decode_blocks = base64_decode_blocks_avx2,
+        .count = base64_count_avx2,
+    },
+#endif
+};
+
+const size_t BASE64_CODECS_COUNT =
+    sizeof(BASE64_CODECS) / sizeof(BASE64_CODECS[0]);
+
+static const struct base64_codec *codec = &BASE64_CODECS[0];
+
+static void __attribute__((constructor))
+base64_select_codec(void)
+{
+#ifdef BASE64_X86
+    __builtin_cpu_init();
+#endif
+    for (size_t i = 0; i < BASE64_CODECS_COUNT; i++) {
+        if (BASE64_CODECS[i].supported())
+            codec = &BASE64_CODECS[i];
+    }
+}
+
+size_t
+base64_encode(char *dest, const char *src, size_t n)
+{
+    return base64_encode_threads(codec, dest, src, n, base64_threads(n));
+}
+
+ssize_t
+base64_decode(char *dest, const char *src, size_t n)
+{
+    return base64_decode_threads(codec, dest, src, n, 0, base64_threads(n));
+}
+
+ssize_t
+base64_decode_strict(char *dest, const char *src, size_t n)
+{
+    return base64_decode_threads(codec, dest, src, n, BASE64_STRICT,
+                                 base64_threads(n));
+}
+
+ssize_t
+base64_decode_bounded(char *dest, size_t capacity, const char *src, size_t n)
+{
+    return decode_bounded(codec, dest, capacity, src, n);
+}
+
+ssize_t
+base64_decoded_size(const char *src, size_t n)
+{
+    return decoded_size(codec, src, n);
+}
+
+ssize_t
+base64_decoder_update(base64_decoder_t *decoder, char *dest, const char *src,
+                      size_t n)
+{
+    return base64_decoder_update_codec(decoder, codec, dest, src, n);
+}
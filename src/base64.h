@@ -8,12 +8,134 @@
 #ifndef BASE64_H
 #define BASE64_H
 
+#include <stdbool.h>
+
 #include <sys/types.h>
 
+#include "miniyaml.h"
+
 size_t
 base64_encode(char *dest, const char *src, size_t n);
 
 ssize_t
 base64_decode(char *dest, const char *src, size_t n);
 
+/* Same as base64_decode(), but padding must complete the last quantum exactly
+ * (any other padding is an encoding error).
+ */
+ssize_t
+base64_decode_strict(char *dest, const char *src, size_t n);
+
+/* Same as base64_decode(), but fails with ENOBUFS rather than writing more
+ * than \p capacity bytes
+ */
+ssize_t
+base64_decode_bounded(char *dest, size_t capacity, const char *src, size_t n);
+
+/* Return the number of bytes base64_decode() would write, without decoding
+ * anything (errors in the placement of padding characters go unnoticed)
+ */
+ssize_t
+base64_decoded_size(const char *src, size_t n);
+
+/*----------------------------------------------------------------------------*
+ |                                  codecs                                    |
+ *----------------------------------------------------------------------------*/
+
+/* base64_encode() and base64_decode() dispatch to the fastest codec the CPU
+ * supports. The choice is made once, when the library is loaded.
+ *
+ * Every codec produces exactly the same output as the scalar one.
+ *
+ * Codecs only decode whole quanta: decode_blocks() stops before the first
+ * quantum it cannot (or does not want to) decode and updates *src accordingly.
+ * It never consumes padding, nor reports errors: base64_decoder_t takes over
+ * from there.
+ *
+ * Decoding in place (dest == src) is supported: decoders never write past the
+ * characters they already read.
+ *
+ * Likewise, count() returns the number of base64 characters in \p src, up to
+ * the first character that is neither a base64 character nor whitespace.
+ */
+
+enum base64_flags {
+    BASE64_STRICT = 0x1,
+};
+
+struct base64_codec {
+    const char *name;
+    bool (*supported)(void);
+    size_t (*encode)(char *dest, const char *src, size_t n);
+    size_t (*decode_blocks)(char *dest, const char **src, const char *end);
+    size_t (*count)(const char **src, const char *end);
+};
+
+/* Ordered from the most portable to the fastest */
+extern const struct base64_codec BASE64_CODECS[];
+extern const size_t BASE64_CODECS_COUNT;
+
+size_t
+base64_encode_scalar(char *dest, const char *src, size_t n);
+
+size_t
+base64_decode_blocks_scalar(char *dest, const char **src, const char *end);
+
+size_t
+base64_count_scalar(const char **src, const char *end);
+
+/* Decode \p src with a specific codec (rather than the fastest one) */
+ssize_t
+base64_decode_codec(const struct base64_codec *codec, char *dest,
+                    const char *src, size_t n, enum base64_flags flags);
+
+ssize_t
+base64_decoder_update_codec(base64_decoder_t *decoder,
+                            const struct base64_codec *codec, char *dest,
+                            const char *src, size_t n);
+
+#if defined(__x86_64__) || defined(__i386__)
+# define BASE64_X86 1
+
+size_t
+base64_encode_sse41(char *dest, const char *src, size_t n);
+
+size_t
+base64_encode_avx2(char *dest, const char *src, size_t n);
+
+size_t
+base64_encode_avx512vbmi(char *dest, const char *src, size_t n);
+
+size_t
+base64_decode_blocks_sse41(char *dest, const char **src, const char *end);
+
+size_t
+base64_decode_blocks_avx2(char *dest, const char **src, const char *end);
+
+size_t
+base64_count_sse41(const char **src, const char *end);
+
+size_t
+base64_count_avx2(const char **src, const char *end);
+#endif
+
+/*----------------------------------------------------------------------------*
+ |                                  threads                                   |
+ *----------------------------------------------------------------------------*/
+
+/* Large inputs are split into parts that are encoded/decoded concurrently */
+
+/* How many threads (including the calling one) to use for \p n bytes */
+unsigned int
+base64_threads(size_t n);
+
+size_t
+base64_encode_threads(const struct base64_codec *codec, char *dest,
+                      const char *src, size_t n, unsigned int threads);
+
+ssize_t
+base64_decode_threads(const struct base64_codec *codec, char *dest,
+                      const char *src, size_t n, enum base64_flags flags,
+                      unsigned int threads);
+
 #endif
@@ -0,0 +1,394 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+
+#include "base64.h"
+#include "miniyaml.h"
+
+/* Inputs are never split into more parts than this */
+#define MAX_THREADS 8
+
+/* Below this many bytes per thread, starting threads is not worth it */
+#define MIN_BYTES_PER_THREAD (4 << 20)
+
+unsigned int
+base64_threads(size_t n)
+{
+    long cpus;
+
+    if (n < 2 * MIN_BYTES_PER_THREAD)
+        return 1;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 2)
+        return 1;
+    if (cpus > MAX_THREADS)
+        cpus = MAX_THREADS;
+
+    return n / MIN_BYTES_PER_THREAD < (size_t)cpus ? n / MIN_BYTES_PER_THREAD
+                                                   : (size_t)cpus;
+}
+
+struct job {
+    const struct base64_codec *codec;
+    char *dest;
+    const char *src;
+    size_t n;
+    bool last;
+    /* Decoding only */
+    bool strict;
+    ssize_t rc;
+};
+
+/*----------------------------------------------------------------------------*
+ |                                    pool                                    |
+ *----------------------------------------------------------------------------*/
+
+/* Jobs are run by a small pool of threads, started the first time they are
+ * needed and kept for the lifetime of the process: large values tend to come
+ * in series, and each of them should not pay for starting and joining threads.
+ *
+ * Callers queue jobs for the pool, and run queued jobs themselves while they
+ * wait for theirs: every job is run exactly once, even if the pool is busy
+ * with other callers' jobs, or could not be started at all.
+ */
+
+/* How many jobs may wait for a thread at once (others are run by the calling
+ * thread right away)
+ */
+#define QUEUE_SIZE (4 * MAX_THREADS)
+
+struct task {
+    void *(*routine)(void *);
+    struct job *job;
+    /* The number of jobs of the same run_jobs() call that are not done yet */
+    unsigned int *pending;
+};
+
+static struct {
+    pthread_mutex_t lock;
+    /* Signaled when a task is queued */
+    pthread_cond_t queued;
+    /* Signaled when a task is done */
+    pthread_cond_t done;
+    struct task tasks[QUEUE_SIZE];
+    unsigned int head;
+    unsigned int count;
+    bool started;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .queued = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+/* Must be called with pool.lock held, which is released while the task runs */
+static void
+run_next_task(void)
+{
+    struct task task = pool.tasks[pool.head];
+
+    pool.head = (pool.head + 1) % QUEUE_SIZE;
+    pool.count--;
+
+    pthread_mutex_unlock(&pool.lock);
+    task.routine(task.job);
+    pthread_mutex_lock(&pool.lock);
+
+    (*task.pending)--;
+    pthread_cond_broadcast(&pool.done);
+}
+
+static void *
+pool_worker(void *data)
+{
+    pthread_mutex_lock(&pool.lock);
+    while (true) {
+        while (pool.count == 0)
+            pthread_cond_wait(&pool.queued, &pool.lock);
+        run_next_task();
+    }
+    return NULL;
+}
+
+/* The threads of the pool do not survive fork() */
+static void
+pool_reset(void)
+{
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.queued, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    pool.head = 0;
+    pool.count = 0;
+    pool.started = false;
+}
+
+static void
+register_pool_reset(void)
+{
+    pthread_atfork(NULL, NULL, pool_reset);
+}
+
+/* Must be called with pool.lock held */
+static void
+pool_start(void)
+{
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_attr_t attr;
+
+    pthread_once(&once, register_pool_reset);
+
+    pool.started = true;
+    if (pthread_attr_init(&attr))
+        return;
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    /* The calling thread always takes its share of the jobs */
+    for (unsigned int i = 1; i < base64_threads(SIZE_MAX); i++) {
+        pthread_t thread;
+
+        if (pthread_create(&thread, &attr, pool_worker, NULL))
+            break;
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+/* Run every job concurrently, the calling thread runs the first one */
+static void
+run_jobs(void *(*routine)(void *), struct job *jobs, unsigned int count)
+{
+    unsigned int pending = 0;
+
+    pthread_mutex_lock(&pool.lock);
+    if (!pool.started)
+        pool_start();
+
+    for (unsigned int i = 1; i < count; i++) {
+        if (pool.count == QUEUE_SIZE) {
+            pthread_mutex_unlock(&pool.lock);
+            routine(&jobs[i]);
+            pthread_mutex_lock(&pool.lock);
+            continue;
+        }
+
+        pool.tasks[(pool.head + pool.count++) % QUEUE_SIZE] = (struct task){
+            .routine = routine,
+            .job = &jobs[i],
+            .pending = &pending,
+        };
+        pending++;
+        pthread_cond_signal(&pool.queued);
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    routine(&jobs[0]);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pending) {
+        if (pool.count)
+            run_next_task();
+        else
+            pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+}
+
+/*----------------------------------------------------------------------------*
+ |                                  encoding                                  |
+ *----------------------------------------------------------------------------*/
+
+/* Every part but the last one is a multiple of 3 bytes: it encodes to a whole
+ * number of quanta, right where the encoding of the whole input would put
+ * them.
+ *
+ * Encoders terminate their output with a null byte, which would overwrite the
+ * first character of the next part: the last quantum of each part is encoded
+ * separately.
+ */
+
+static void *
+encode_job(void *data)
+{
+    struct job *job = data;
+    char quantum[5];
+
+    if (job->last) {
+        job->codec->encode(job->dest, job->src, job->n);
+        return NULL;
+    }
+
+    job->codec->encode(job->dest, job->src, job->n - 3);
+    job->codec->encode(quantum, job->src + job->n - 3, 3);
+    memcpy(job->dest + (job->n - 3) / 3 * 4, quantum, 4);
+    return NULL;
+}
+
+size_t
+base64_encode_threads(const struct base64_codec *codec, char *dest,
+                      const char *src, size_t n, unsigned int threads)
+{
+    struct job jobs[MAX_THREADS];
+    size_t part;
+
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    part = threads ? n / threads / 3 * 3 : 0;
+    if (threads < 2 || part == 0)
+        return codec->encode(dest, src, n);
+
+    for (unsigned int i = 0; i < threads; i++) {
+        jobs[i] = (struct job){
+            .codec = codec,
+            .dest = dest + i * part / 3 * 4,
+            .src = src + i * part,
+            .n = i + 1 < threads ? part : n - i * part,
+            .last = i + 1 == threads,
+        };
+    }
+
+    run_jobs(encode_job, jobs, threads);
+    return (n + 2) / 3 * 4;
+}
+
+/*----------------------------------------------------------------------------*
+ |                                  decoding                                  |
+ *----------------------------------------------------------------------------*/
+
+/* Because of whitespace, where the decoding of a part starts in the output
+ * cannot be derived from where it starts in the input. Decoding is thus done
+ * in two passes:
+ *   - every part but the last one counts its base64 characters;
+ *   - part boundaries are moved forward to the next quantum boundary, and
+ *     every part is decoded where its first quantum belongs.
+ *
+ * Every part but the last one must end on a whole quantum: padding or garbage
+ * anywhere else than in the last part is left to the sequential decoder, which
+ * reports errors exactly.
+ */
+
+static inline bool
+is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static void *
+count_job(void *data)
+{
+    struct job *job = data;
+    const char *end = job->src + job->n;
+    const char *src = job->src;
+
+    job->rc = job->codec->count(&src, end);
+    /* Stopped on padding or garbage */
+    if (src != end)
+        job->rc = -1;
+    return NULL;
+}
+
+static void *
+decode_job(void *data)
+{
+    struct job *job = data;
+    base64_decoder_t decoder;
+    ssize_t tail;
+
+    base64_decoder_init(&decoder, job->strict);
+    job->rc = base64_decoder_update_codec(&decoder, job->codec, job->dest,
+                                          job->src, job->n);
+    if (job->rc < 0)
+        return NULL;
+
+    tail = base64_decoder_finish(&decoder, job->dest + job->rc);
+    if (tail < 0 || (!job->last && tail > 0))
+        job->rc = -1;
+    else
+        job->rc += tail;
+    return NULL;
+}
+
+ssize_t
+base64_decode_threads(const struct base64_codec *codec, char *dest,
+                      const char *src, size_t n, enum base64_flags flags,
+                      unsigned int threads)
+{
+    const char *end = src + n;
+    struct job jobs[MAX_THREADS];
+    size_t characters = 0;
+    size_t written = 0;
+
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+
+    /* Parts are decoded concurrently: one must not overwrite the input of
+     * another.
+     */
+    if (threads < 2 || n / threads < 4 || (dest < end && src < dest + n))
+        return base64_decode_codec(codec, dest, src, n, flags);
+
+    for (unsigned int i = 0; i < threads; i++) {
+        jobs[i] = (struct job){
+            .codec = codec,
+            .src = src + i * (n / threads),
+            .n = i + 1 < threads ? n / threads : n - i * (n / threads),
+            .last = i + 1 == threads,
+            .strict = flags & BASE64_STRICT,
+        };
+    }
+
+    run_jobs(count_job, jobs, threads - 1);
+
+    for (unsigned int i = 1; i < threads; i++) {
+        const char *boundary = jobs[i].src;
+        size_t moved = 0;
+
+        if (jobs[i - 1].rc < 0)
+            goto sequential;
+        characters += jobs[i - 1].rc;
+
+        /* Move to the start of the next quantum */
+        while ((characters + moved) % 4) {
+            if (boundary == end)
+                goto sequential;
+            if (!is_space(*boundary++))
+                moved++;
+        }
+        if (boundary > jobs[i].src + jobs[i].n)
+            goto sequential;
+
+        /* These characters were counted as part of jobs[i] */
+        characters += moved;
+        if (i + 1 < threads)
+            jobs[i].rc -= moved;
+
+        jobs[i - 1].n = boundary - jobs[i - 1].src;
+        jobs[i].n -= boundary - jobs[i].src;
+        jobs[i].src = boundary;
+        jobs[i].dest = dest + characters / 4 * 3;
+    }
+    jobs[0].dest = dest;
+
+    run_jobs(decode_job, jobs, threads);
+
+    for (unsigned int i = 0; i < threads; i++) {
+        if (jobs[i].rc < 0 || jobs[i].dest != dest + written)
+            goto sequential;
+        written += jobs[i].rc;
+    }
+    return written;
+
+sequential:
+    return base64_decode_codec(codec, dest, src, n, flags);
+}
@@ -0,0 +1,567 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#include "base64.h"
+
+/* SIMD base64 codecs for x86 processors
+ *
+ * Every function in this file is compiled for a specific instruction set (using
+ * GCC's target attribute) and must only be called once the corresponding CPU
+ * feature has been detected (cf. BASE64_CODECS in base64.c).
+ *
+ * The kernels follow Wojciech Muła and Daniel Lemire's "Faster Base64 Encoding
+ * and Decoding using AVX2 Instructions" (ACM TOW, 2018). Each kernel processes
+ * as many blocks as it safely can and leaves the remaining bytes to the next
+ * narrower one, down to base64_{en,de}code_scalar().
+ */
+
+#ifdef BASE64_X86
+
+#include <immintrin.h>
+
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512VBMI \
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+
+static const char ALPHABET[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/*----------------------------------------------------------------------------*
+ |                                  encoding                                  |
+ *----------------------------------------------------------------------------*/
+
+    /*--------------------------------------------------------------------*
+     |                               sse4.1                               |
+     *--------------------------------------------------------------------*/
+
+/* Spread 12 bytes of input over 16 bytes, one 6-bit value per byte */
+static inline __m128i TARGET_SSE41
+enc_reshuffle_sse41(__m128i in)
+{
+    __m128i t1;
+    __m128i t3;
+
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                            7, 6, 8, 7, 10, 9, 11, 10));
+    t1 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                         _mm_set1_epi32(0x04000040));
+    t3 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                         _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+/* Translate 6-bit values into their ASCII representation */
+static inline __m128i TARGET_SSE41
+enc_translate_sse41(__m128i in)
+{
+    const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4,
+                                      -4, -4, -4, -4, -19, -16, 0, 0);
+    __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    __m128i mask = _mm_cmpgt_epi8(in, _mm_set1_epi8(25));
+
+    indices = _mm_sub_epi8(indices, mask);
+    return _mm_add_epi8(in, _mm_shuffle_epi8(lut, indices));
+}
+
+size_t TARGET_SSE41
+base64_encode_sse41(char *dest, const char *src, size_t n)
+{
+    size_t i = 0, j = 0;
+
+    /* 12 bytes are consumed per iteration, but 16 are loaded */
+    for (; n - i >= 16; i += 12, j += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(src + i));
+
+        in = enc_translate_sse41(enc_reshuffle_sse41(in));
+        _mm_storeu_si128((__m128i *)(dest + j), in);
+    }
+
+    return j + base64_encode_scalar(dest + j, src + i, n - i);
+}
+
+    /*--------------------------------------------------------------------*
+     |                                avx2                                |
+     *--------------------------------------------------------------------*/
+
+static inline __m256i TARGET_AVX2
+enc_reshuffle_avx2(__m256i in)
+{
+    __m256i t1;
+    __m256i t3;
+
+    in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                                  7, 6, 8, 7, 10, 9, 11, 10,
+                                                  1, 0, 2, 1, 4, 3, 5, 4,
+                                                  7, 6, 8, 7, 10, 9, 11, 10));
+    t1 = _mm256_mulhi_epu16(_mm256_and_si256(in,
+                                             _mm256_set1_epi32(0x0fc0fc00)),
+                            _mm256_set1_epi32(0x04000040));
+    t3 = _mm256_mullo_epi16(_mm256_and_si256(in,
+                                             _mm256_set1_epi32(0x003f03f0)),
+                            _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t1, t3);
+}
+
+static inline __m256i TARGET_AVX2
+enc_translate_avx2(__m256i in)
+{
+    const __m256i lut = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4,
+                                         -4, -4, -4, -4, -19, -16, 0, 0,
+                                         65, 71, -4, -4, -4, -4, -4, -4,
+                                         -4, -4, -4, -4, -19, -16, 0, 0);
+    __m256i indices = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+    __m256i mask = _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25));
+
+    indices = _mm256_sub_epi8(indices, mask);
+    return _mm256_add_epi8(in, _mm256_shuffle_epi8(lut, indices));
+}
+
+size_t TARGET_AVX2
+base64_encode_avx2(char *dest, const char *src, size_t n)
+{
+    size_t i = 0, j = 0;
+
+    /* 24 bytes are consumed per iteration, but 28 are loaded */
+    for (; n - i >= 28; i += 24, j += 32) {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(src + i + 12));
+        __m256i in;
+
+        in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = enc_translate_avx2(enc_reshuffle_avx2(in));
+        _mm256_storeu_si256((__m256i *)(dest + j), in);
+    }
+
+    return j + base64_encode_sse41(dest + j, src + i, n - i);
+}
+
+    /*--------------------------------------------------------------------*
+     |                             avx512vbmi                             |
+     *--------------------------------------------------------------------*/
+
+size_t TARGET_AVX512VBMI
+base64_encode_avx512vbmi(char *dest, const char *src, size_t n)
+{
+    /* Each 32-bit lane gathers the bytes [b, a, c, b] of a 3-byte group */
+    const __m512i shuffle = _mm512_setr_epi32(
+        0x01020001, 0x04050304, 0x07080607, 0x0a0b090a,
+        0x0d0e0c0d, 0x10110f10, 0x13141213, 0x16171516,
+        0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122,
+        0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e
+        );
+    /* Bit offsets of each 6-bit value in those lanes */
+    const __m512i shifts = _mm512_set1_epi64(0x3036242a1016040a);
+    const __m512i lookup = _mm512_loadu_si512(ALPHABET);
+    size_t i = 0, j = 0;
+
+    /* 48 bytes are consumed per iteration, but 64 are loaded */
+    for (; n - i >= 64; i += 48, j += 64) {
+        __m512i in = _mm512_loadu_si512(src + i);
+
+        in = _mm512_permutexvar_epi8(shuffle, in);
+        in = _mm512_multishift_epi64_epi8(shifts, in);
+        in = _mm512_permutexvar_epi8(in, lookup);
+        _mm512_storeu_si512(dest + j, in);
+    }
+
+    return j + base64_encode_avx2(dest + j, src + i, n - i);
+}
+
+/*----------------------------------------------------------------------------*
+ |                                  decoding                                  |
+ *----------------------------------------------------------------------------*/
+
+/* The decoding kernels translate and validate a whole block of characters at
+ * once. Blocks that only contain base64 characters are decoded right away.
+ * Blocks that also contain whitespace (typically line breaks in a folded
+ * scalar) are compacted into a staging area first, and decoded from there
+ * once enough of them have piled up.
+ *
+ * Blocks with any other character (padding or garbage) stop the kernels, the
+ * scalar code then takes over from the start of the current quantum. It is the
+ * one responsible for reporting errors and handling padding.
+ */
+
+/* Staged values are decoded in batches: packing them as soon as 16 are
+ * available means reloading bytes that were just stored piecewise, which
+ * defeats store-to-load forwarding and stalls on every block.
+ */
+#define STAGE_BATCH 128
+
+struct decoder {
+    uint8_t *dest;
+    /* 6-bit values waiting to be decoded */
+    uint8_t stage[STAGE_BATCH + 32];
+    size_t staged;
+};
+
+/* For each 8-bit mask, the position of the bits that are set (in order),
+ * padded with 0x80 (ie. "zero this byte" for pshufb).
+ */
+static uint8_t compact_shuffles[256][8];
+
+static void __attribute__((constructor))
+init_compact_shuffles(void)
+{
+    for (unsigned int mask = 0; mask < 256; mask++) {
+        size_t k = 0;
+
+        for (unsigned int bit = 0; bit < 8; bit++) {
+            if (mask & (1 << bit))
+                compact_shuffles[mask][k++] = bit;
+        }
+        while (k < 8)
+            compact_shuffles[mask][k++] = 0x80;
+    }
+}
+
+static inline bool
+is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/* Decode whatever full quanta remain in the staging area, and return a pointer
+ * to the first character of the quantum that could not be completed.
+ */
+static const char *
+dec_finish(struct decoder *decoder, const char *src)
+{
+    const uint8_t *values = decoder->stage;
+    size_t leftover = decoder->staged % 4;
+
+    for (size_t i = 0; i + 4 <= decoder->staged; i += 4, values += 4) {
+        *decoder->dest++ = values[0] << 2 | values[1] >> 4;
+        *decoder->dest++ = values[1] << 4 | values[2] >> 2;
+        *decoder->dest++ = values[2] << 6 | values[3];
+    }
+
+    /* Every character the kernels consumed is either whitespace or a base64
+     * character that was staged.
+     */
+    while (leftover) {
+        if (!is_space(*--src))
+            leftover--;
+    }
+
+    decoder->staged = 0;
+    return src;
+}
+
+    /*--------------------------------------------------------------------*
+     |                               sse4.1                               |
+     *--------------------------------------------------------------------*/
+
+/* Translate 16 characters into 6-bit values
+ *
+ * Return false if the block contains anything but base64 characters and
+ * whitespace, otherwise, \p spaces is set to a mask of the whitespace in the
+ * block.
+ */
+static inline bool TARGET_SSE41
+dec_translate_sse41(__m128i in, __m128i *values, unsigned int *spaces)
+{
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x11, 0x11, 0x13, 0x1a,
+                                         0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                         0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                         0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+    __m128i lo_nibbles = _mm_and_si128(in, mask_2f);
+    __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    __m128i valid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi),
+                                   _mm_setzero_si128());
+    __m128i shifted = _mm_sub_epi8(in, _mm_set1_epi8('\t'));
+    __m128i space;
+    __m128i roll;
+
+    /* ' ' or '\t' <= c <= '\r' */
+    space = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8(' ')),
+                         _mm_cmpeq_epi8(_mm_min_epu8(shifted,
+                                                     _mm_set1_epi8(4)),
+                                        shifted));
+    if (_mm_movemask_epi8(_mm_or_si128(valid, space)) != 0xffff)
+        return false;
+
+    *spaces = _mm_movemask_epi8(space);
+    roll = _mm_shuffle_epi8(lut_roll,
+                            _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2f),
+                                         hi_nibbles));
+    *values = _mm_add_epi8(in, roll);
+    return true;
+}
+
+/* Pack 16 6-bit values into 12 bytes */
+static inline void TARGET_SSE41
+dec_pack_sse41(uint8_t *dest, __m128i values)
+{
+    uint32_t tail;
+
+    values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+    values = _mm_shuffle_epi8(values, _mm_setr_epi8(2, 1, 0, 6, 5, 4,
+                                                    10, 9, 8, 14, 13, 12,
+                                                    -1, -1, -1, -1));
+    /* Never write past the 12 bytes (the output buffer is sized exactly) */
+    _mm_storel_epi64((__m128i *)dest, values);
+    tail = _mm_extract_epi32(values, 2);
+    memcpy(dest + 8, &tail, sizeof(tail));
+}
+
+static inline void TARGET_SSE41
+dec_values_sse41(struct decoder *decoder, __m128i values, unsigned int spaces)
+{
+    if (spaces == 0 && decoder->staged == 0) {
+        dec_pack_sse41(decoder->dest, values);
+        decoder->dest += 12;
+        return;
+    }
+
+    if (spaces == 0) {
+        _mm_storeu_si128((__m128i *)(decoder->stage + decoder->staged),
+                         values);
+        decoder->staged += 16;
+    } else {
+        unsigned int lo = ~spaces & 0xff;
+        unsigned int hi = ~spaces >> 8 & 0xff;
+        __m128i shuffle;
+
+        shuffle = _mm_unpacklo_epi64(
+            _mm_loadl_epi64((const __m128i *)compact_shuffles[lo]),
+            _mm_add_epi8(
+                _mm_loadl_epi64((const __m128i *)compact_shuffles[hi]),
+                _mm_set1_epi8(8)
+                )
+            );
+        values = _mm_shuffle_epi8(values, shuffle);
+
+        _mm_storel_epi64((__m128i *)(decoder->stage + decoder->staged),
+                         values);
+        decoder->staged += __builtin_popcount(lo);
+        _mm_storel_epi64((__m128i *)(decoder->stage + decoder->staged),
+                         _mm_unpackhi_epi64(values, values));
+        decoder->staged += __builtin_popcount(hi);
+    }
+
+    if (decoder->staged < STAGE_BATCH)
+        return;
+
+    for (size_t i = 0; i < STAGE_BATCH; i += 16) {
+        dec_pack_sse41(decoder->dest,
+                       _mm_loadu_si128((const __m128i *)(decoder->stage + i)));
+        decoder->dest += 12;
+    }
+    _mm_storeu_si128((__m128i *)decoder->stage,
+                     _mm_loadu_si128((const __m128i *)(decoder->stage
+                                                       + STAGE_BATCH)));
+    decoder->staged -= STAGE_BATCH;
+}
+
+static inline bool TARGET_SSE41
+dec_block_sse41(struct decoder *decoder, const char *src)
+{
+    __m128i in = _mm_loadu_si128((const __m128i *)src);
+    unsigned int spaces;
+    __m128i values;
+
+    if (!dec_translate_sse41(in, &values, &spaces))
+        return false;
+
+    dec_values_sse41(decoder, values, spaces);
+    return true;
+}
+
+static size_t
+dec_tail(struct decoder *decoder, char *dest, const char **src,
+         const char *end)
+{
+    *src = dec_finish(decoder, *src);
+    decoder->dest += base64_decode_blocks_scalar((char *)decoder->dest, src,
+                                                 end);
+    return (char *)decoder->dest - dest;
+}
+
+size_t TARGET_SSE41
+base64_decode_blocks_sse41(char *dest, const char **src, const char *end)
+{
+    struct decoder decoder = {
+        .dest = (uint8_t *)dest,
+    };
+    const char *input = *src;
+
+    while (end - input >= 16 && dec_block_sse41(&decoder, input))
+        input += 16;
+
+    *src = input;
+    return dec_tail(&decoder, dest, src, end);
+}
+
+size_t TARGET_SSE41
+base64_count_sse41(const char **src, const char *end)
+{
+    const char *input = *src;
+    size_t count = 0;
+
+    while (end - input >= 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)input);
+        unsigned int spaces;
+        __m128i values;
+
+        if (!dec_translate_sse41(in, &values, &spaces))
+            break;
+        count += 16 - __builtin_popcount(spaces);
+        input += 16;
+    }
+
+    *src = input;
+    return count + base64_count_scalar(src, end);
+}
+
+    /*--------------------------------------------------------------------*
+     |                                avx2                                |
+     *--------------------------------------------------------------------*/
+
+static inline bool TARGET_AVX2
+dec_translate_avx2(__m256i in, __m256i *values, uint32_t *spaces)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x11, 0x11, 0x13, 0x1a,
+                                            0x1b, 0x1b, 0x1b, 0x1a,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x11, 0x11, 0x13, 0x1a,
+                                            0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                            0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                            0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+    __m256i lo_nibbles = _mm256_and_si256(in, mask_2f);
+    __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    __m256i valid = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi),
+                                      _mm256_setzero_si256());
+    __m256i shifted = _mm256_sub_epi8(in, _mm256_set1_epi8('\t'));
+    __m256i space;
+    __m256i roll;
+
+    space = _mm256_or_si256(
+        _mm256_cmpeq_epi8(in, _mm256_set1_epi8(' ')),
+        _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(4)),
+                          shifted)
+        );
+    if (~_mm256_movemask_epi8(_mm256_or_si256(valid, space)))
+        return false;
+
+    *spaces = _mm256_movemask_epi8(space);
+    roll = _mm256_shuffle_epi8(lut_roll,
+                               _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask_2f),
+                                               hi_nibbles));
+    *values = _mm256_add_epi8(in, roll);
+    return true;
+}
+
+/* Pack 32 6-bit values into 24 bytes */
+static inline void TARGET_AVX2
+dec_pack_avx2(uint8_t *dest, __m256i values)
+{
+    values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+    values = _mm256_shuffle_epi8(values,
+                                 _mm256_setr_epi8(2, 1, 0, 6, 5, 4,
+                                                  10, 9, 8, 14, 13, 12,
+                                                  -1, -1, -1, -1,
+                                                  2, 1, 0, 6, 5, 4,
+                                                  10, 9, 8, 14, 13, 12,
+                                                  -1, -1, -1, -1));
+    values = _mm256_permutevar8x32_epi32(values,
+                                         _mm256_setr_epi32(0, 1, 2, 4, 5, 6,
+                                                           -1, -1));
+    _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(values));
+    _mm_storel_epi64((__m128i *)(dest + 16),
+                     _mm256_extracti128_si256(values, 1));
+}
+
+static inline bool TARGET_AVX2
+dec_block_avx2(struct decoder *decoder, const char *src)
+{
+    __m256i in = _mm256_loadu_si256((const __m256i *)src);
+    uint32_t spaces;
+    __m256i values;
+
+    if (!dec_translate_avx2(in, &values, &spaces))
+        return false;
+
+    if (spaces == 0 && decoder->staged == 0) {
+        dec_pack_avx2(decoder->dest, values);
+        decoder->dest += 24;
+        return true;
+    }
+
+    dec_values_sse41(decoder, _mm256_castsi256_si128(values), spaces & 0xffff);
+    dec_values_sse41(decoder, _mm256_extracti128_si256(values, 1),
+                     spaces >> 16);
+    return true;
+}
+
+size_t TARGET_AVX2
+base64_decode_blocks_avx2(char *dest, const char **src, const char *end)
+{
+    struct decoder decoder = {
+        .dest = (uint8_t *)dest,
+    };
+    const char *input = *src;
+
+    while (end - input >= 32 && dec_block_avx2(&decoder, input))
+        input += 32;
+    while (end - input >= 16 && dec_block_sse41(&decoder, input))
+        input += 16;
+
+    *src = input;
+    return dec_tail(&decoder, dest, src, end);
+}
+
+size_t TARGET_AVX2
+base64_count_avx2(const char **src, const char *end)
+{
+    const char *input = *src;
+    size_t count = 0;
+
+    while (end - input >= 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)input);
+        uint32_t spaces;
+        __m256i values;
+
+        if (!dec_translate_avx2(in, &values, &spaces))
+            break;
+        count += 32 - __builtin_popcount(spaces);
+        input += 32;
+    }
+
+    *src = input;
+    return count + base64_count_sse41(src, end);
+}
+
+#endif
@@ -0,0 +1,36 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#ifndef FLOAT_FMT_H
+#define FLOAT_FMT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Large enough for any output of float_format() (including a null byte) */
+#define FLOAT_FORMAT_SIZE 32
+
+/* Write the shortest representation of \p d that parses back to \p d
+ *
+ * The output is locale-independent, null-terminated, and always recognizable
+ * as a float by YAML 1.1 and 1.2 resolvers: "1.0", "0.001", "1.5e+300",
+ * ".inf", "-.inf" or ".nan".
+ *
+ * Return the number of characters written (excluding the null byte).
+ */
+size_t
+float_format(char dest[FLOAT_FORMAT_SIZE], double d);
+
+/* Parse the \p n characters at \p src as a YAML float, round to nearest
+ *
+ * Return false and set errno to EINVAL if \p src is not a float, or to ERANGE
+ * if it is too large (or too small) to be represented as a (non-zero) double.
+ */
+bool
+float_parse(const char *src, size_t n, double *d);
+
+#endif
@@ -0,0 +1,224 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sys/types.h>
+
+#include "hex.h"
+
+/* Each kernel converts 16 bytes to 32 digits (or the other way around) at a
+ * time and leaves the remaining bytes to the scalar code.
+ *
+ * SSE2 is part of x86-64: no runtime detection is needed.
+ */
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+static const char DIGITS[16] = "0123456789abcdef";
+
+/* Return the value of a hexadecimal digit, or a value greater than 15 */
+static inline unsigned int
+nibble(char c)
+{
+    const unsigned int u = (unsigned char)c;
+
+    if (u - '0' < 10)
+        return u - '0';
+    if ((u | 0x20) - 'a' < 6)
+        return (u | 0x20) - 'a' + 10;
+    return 16;
+}
+
+/*----------------------------------------------------------------------------*
+ |                                  encoding                                  |
+ *----------------------------------------------------------------------------*/
+
+#ifdef __SSE2__
+/* Turn 16 nibbles (one per byte) into as many digits */
+static inline __m128i
+nibbles2digits(__m128i nibbles)
+{
+    const __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+
+    /* '0' + n, or 'a' + n - 10 */
+    return _mm_add_epi8(nibbles,
+                        _mm_add_epi8(_mm_set1_epi8('0'),
+                                     _mm_and_si128(letters,
+                                                   _mm_set1_epi8('a' - '0'
+                                                                 - 10))));
+}
+
+static inline void
+encode_block(char *dest, const char *src)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    __m128i in, high, low;
+
+    in = _mm_loadu_si128((const __m128i *)src);
+    high = _mm_and_si128(_mm_srli_epi16(in, 4), mask);
+    low = _mm_and_si128(in, mask);
+
+    _mm_storeu_si128((__m128i *)dest,
+                     nibbles2digits(_mm_unpacklo_epi8(high, low)));
+    _mm_storeu_si128((__m128i *)(dest + 16),
+                     nibbles2digits(_mm_unpackhi_epi8(high, low)));
+}
+#endif
+
+static inline __attribute__((always_inline)) size_t
+encode(char *dest, const char *src, size_t n)
+{
+    size_t i = 0;
+
+#ifdef __SSE2__
+    for (; n - i >= 16; i += 16)
+        encode_block(dest + 2 * i, src + i);
+#endif
+
+    for (; i < n; i++) {
+        const unsigned char byte = src[i];
+
+        dest[2 * i] = DIGITS[byte >> 4];
+        dest[2 * i + 1] = DIGITS[byte & 0xf];
+    }
+
+    dest[2 * n] = '\0';
+    return 2 * n;
+}
+
+size_t
+hex_encode(char *dest, const char *src, size_t n)
+{
+    return encode(dest, src, n);
+}
+
+/*----------------------------------------------------------------------------*
+ |                                  decoding                                  |
+ *----------------------------------------------------------------------------*/
+
+#ifdef __SSE2__
+/* Turn 16 digits into as many nibbles, return false on invalid digits */
+static inline bool
+digits2nibbles(__m128i digits, __m128i *nibbles)
+{
+    const __m128i minus_one = _mm_set1_epi8(-1);
+    __m128i decimal, letter, is_decimal, is_letter;
+
+    /* Bytes are compared as signed integers: the subtraction maps the valid
+     * range to [0, 9] (or [0, 5]), and anything else out of it.
+     */
+    decimal = _mm_sub_epi8(digits, _mm_set1_epi8('0'));
+    is_decimal = _mm_and_si128(_mm_cmpgt_epi8(decimal, minus_one),
+                               _mm_cmplt_epi8(decimal, _mm_set1_epi8(10)));
+
+    letter = _mm_sub_epi8(_mm_or_si128(digits, _mm_set1_epi8(0x20)),
+                          _mm_set1_epi8('a'));
+    is_letter = _mm_and_si128(_mm_cmpgt_epi8(letter, minus_one),
+                              _mm_cmplt_epi8(letter, _mm_set1_epi8(6)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(is_decimal, is_letter)) != 0xffff)
+        return false;
+
+    *nibbles = _mm_or_si128(_mm_and_si128(is_decimal, decimal),
+                            _mm_and_si128(is_letter,
+                                          _mm_add_epi8(letter,
+                                                       _mm_set1_epi8(10))));
+    return true;
+}
+
+/* Combine pairs of nibbles into bytes (the first one is the high nibble) */
+static inline __m128i
+pack_nibbles(__m128i nibbles)
+{
+    return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles,
+                                                     _mm_set1_epi16(0xff)),
+                                       4),
+                        _mm_srli_epi16(nibbles, 8));
+}
+
+static inline bool
+decode_block(char *dest, const char *src)
+{
+    __m128i first, second;
+
+    if (!digits2nibbles(_mm_loadu_si128((const __m128i *)src), &first)
+     || !digits2nibbles(_mm_loadu_si128((const __m128i *)(src + 16)),
+                        &second))
+        return false;
+
+    _mm_storeu_si128((__m128i *)dest,
+                     _mm_packus_epi16(pack_nibbles(first),
+                                      pack_nibbles(second)));
+    return true;
+}
+#endif
+
+static inline __attribute__((always_inline)) ssize_t
+decode(char *dest, const char *src, size_t n)
+{
+    size_t i = 0;
+
+    if (n % 2)
+        goto out_eilseq;
+    n /= 2;
+
+#ifdef __SSE2__
+    for (; n - i >= 16; i += 16) {
+        if (!decode_block(dest + i, src + 2 * i))
+            goto out_eilseq;
+    }
+#endif
+
+    for (; i < n; i++) {
+        const unsigned int high = nibble(src[2 * i]);
+        const unsigned int low = nibble(src[2 * i + 1]);
+
+        if (high > 15 || low > 15)
+            goto out_eilseq;
+        dest[i] = high << 4 | low;
+    }
+
+    return n;
+
+out_eilseq:
+    errno = EILSEQ;
+    return -1;
+}
+
+ssize_t
+hex_decode(char *dest, const char *src, size_t n)
+{
+    return decode(dest, src, n);
+}
+
+/*----------------------------------------------------------------------------*
+ |                                identifiers                                 |
+ *----------------------------------------------------------------------------*/
+
+/* The size is known at compile time: loops are fully unrolled */
+
+#define DEFINE_HEX_CODEC(bytes) \
+size_t \
+hex_encode_ ## bytes(char *dest, const char *src) \
+{ \
+    return encode(dest, src, bytes); \
+} \
+ \
+ssize_t \
+hex_decode_ ## bytes(char *dest, const char *src) \
+{ \
+    return decode(dest, src, 2 * bytes); \
+}
+
+DEFINE_HEX_CODEC(16)
+DEFINE_HEX_CODEC(20)
+DEFINE_HEX_CODEC(32)
@@ -0,0 +1,54 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#ifndef HEX_H
+#define HEX_H
+
+#include <stddef.h>
+
+#include <sys/types.h>
+
+/* Write the \p n bytes at \p src as 2 * \p n lowercase hexadecimal digits
+ * (followed by a null byte)
+ *
+ * Return the number of characters written (excluding the null byte).
+ */
+size_t
+hex_encode(char *dest, const char *src, size_t n);
+
+/* Decode the \p n hexadecimal digits (of either case) at \p src
+ *
+ * Return the number of bytes written (n / 2), or -1 and set errno to EILSEQ if
+ * \p n is odd or \p src contains anything but hexadecimal digits (in which case
+ * the content of \p dest is undefined).
+ */
+ssize_t
+hex_decode(char *dest, const char *src, size_t n);
+
+/* Same as hex_encode() and hex_decode(), for identifiers of common sizes
+ * (\p src is 2 * \p bytes characters long when decoding)
+ */
+
+size_t
+hex_encode_16(char *dest, const char *src);
+
+size_t
+hex_encode_20(char *dest, const char *src);
+
+size_t
+hex_encode_32(char *dest, const char *src);
+
+ssize_t
+hex_decode_16(char *dest, const char *src);
+
+ssize_t
+hex_decode_20(char *dest, const char *src);
+
+ssize_t
+hex_decode_32(char *dest, const char *src);
+
+#endif
@@ -7,14 +7,226 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "base64.h"
+#include "float_fmt.h"
+#include "hex.h"
 #include "miniyaml.h"
+#include "timestamp.h"
+
+#define BYTES(x) (0x0101010101010101ULL * (x))
+
+/* Whether the libyaml this library runs with is one whose internals (the
+ * members of its structures yaml.h documents as internal) were checked
+ *
+ * The functions that reach into those internals fall back to libyaml's public
+ * API with any other release.
+ */
+static bool
+libyaml_internals_checked(void)
+{
+    int major, minor, patch;
+
+    yaml_get_version(&major, &minor, &patch);
+    return major == 0 && minor == 2 && patch == 5;
+}
+
+/* Width of the line break at @p, or 0 if there is none
+ *
+ * Mirrors what libyaml considers a line break.
+ */
+static size_t
+line_break_width(const unsigned char *p, const unsigned char *end)
+{
+    switch (*p) {
+    case '\n':
+        return 1;
+    case '\r':
+        return end - p > 1 && p[1] == '\n' ? 2 : 1;
+    case 0xc2: /* NEL */
+        return end - p > 1 && p[1] == 0x85 ? 2 : 0;
+    case 0xe2: /* LS, PS */
+        return end - p > 2 && p[1] == 0x80 && (p[2] == 0xa8 || p[2] == 0xa9)
+            ? 3 : 0;
+    default:
+        return 0;
+    }
+}
+
+/* Non-zero if any byte of @word is @c */
+static inline uint64_t
+has_byte(uint64_t word, unsigned char c)
+{
+    const uint64_t x = word ^ BYTES(c);
+
+    return (x - BYTES(0x01)) & ~x & BYTES(0x80);
+}
+
+/* Start of the line that follows the one @p is in, NULL if it is the last */
+static const unsigned char *
+next_line(const unsigned char *p, const unsigned char *end)
+{
+    while (p < end) {
+        const unsigned char *stop = end - p < 8 ? end : p + 8;
+
+        if (stop == p + 8) {
+            uint64_t word;
+
+            /* Skip words that cannot hold a line break, 8 bytes at a time */
+            memcpy(&word, p, sizeof(word));
+            if (!(has_byte(word, '\n') | has_byte(word, '\r')
+                | has_byte(word, 0xc2) | has_byte(word, 0xe2))) {
+                p = stop;
+                continue;
+            }
+        }
+
+        for (; p < stop; p++) {
+            const size_t width = line_break_width(p, end);
+
+            if (width)
+                return p + width;
+        }
+    }
+
+    return NULL;
+}
+
+static bool
+is_document_marker(const unsigned char *line, const unsigned char *end)
+{
+    if (end - line < 3)
+        return false;
+
+    if (memcmp(line, "---", 3) != 0 && memcmp(line, "...", 3) != 0)
+        return false;
+
+    return end - line == 3 || line[3] == ' ' || line[3] == '\t'
+        || line_break_width(line + 3, end);
+}
+
+static size_t
+count_characters(const unsigned char *p, const unsigned char *end)
+{
+    size_t count = 0;
+
+    /* Count every byte that does not continue a UTF-8 sequence */
+    while (p < end)
+        count += (*p++ & 0xc0) != 0x80;
+
+    return count;
+}
+
+/* Whether @parser reads from yaml_parser_set_input_string() */
+static bool
+reads_string(const yaml_parser_t *parser)
+{
+    yaml_parser_t string_parser = {};
+
+    /* libyaml does not export its string reader, borrow it */
+    yaml_parser_set_input_string(&string_parser, (const unsigned char *)"", 0);
+    return parser->read_handler == string_parser.read_handler
+        && parser->read_handler_data == parser;
+}
+
+/* Skip the content of a document without going through libyaml's scanner
+ *
+ * Only possible right after an explicit document start marker ("---"), when
+ * the input is an UTF-8 string: the scanner holds no state then, and a "---"
+ * or "..." at the start of a line is always a document boundary. The reader
+ * is moved to the next such marker, and the parser is left as if it had just
+ * parsed the (empty) content of the document.
+ *
+ * Returns false if the parser is not in a state that allows it.
+ */
+static bool
+skip_document_content(yaml_parser_t *parser)
+{
+    const unsigned char *position, *line, *end;
+    yaml_mark_t mark;
+    size_t buffered;
+
+    if (!reads_string(parser) || parser->encoding != YAML_UTF8_ENCODING)
+        return false;
+
+    if (parser->error != YAML_NO_ERROR
+     || parser->state != YAML_PARSE_DOCUMENT_CONTENT_STATE
+     || parser->tokens.head != parser->tokens.tail
+     || parser->flow_level != 0)
+        return false;
+
+    /* UTF-8 input is buffered as is, with a trailing NUL once it is read */
+    buffered = parser->buffer.last - parser->buffer.pointer;
+    if (parser->eof && parser->raw_buffer.pointer == parser->raw_buffer.last)
+        buffered--;
+
+    end = parser->input.string.end;
+    position = parser->input.string.current - buffered
+             - (parser->raw_buffer.last - parser->raw_buffer.pointer);
+
+    mark = parser->mark;
+    /* The scanner stands right after "---", not at the start of a line */
+    line = position;
+    while (line < end) {
+        const unsigned char *next = next_line(line, end);
+
+        if (next == NULL) {
+            mark.column += count_characters(line, end);
+            line = end;
+            break;
+        }
+
+        mark.line++;
+        mark.column = 0;
+        line = next;
+
+        if (is_document_marker(line, end))
+            break;
+    }
+    mark.index += count_characters(position, line);
+
+    if ((size_t)(line - position) <= buffered) {
+        /* The marker is already decoded */
+        parser->buffer.pointer += line - position;
+        parser->unread -= mark.index - parser->mark.index;
+    } else {
+        const unsigned char *raw = position + buffered;
+
+        parser->buffer.pointer = parser->buffer.start;
+        parser->buffer.last = parser->buffer.start;
+        parser->unread = 0;
+
+        if (line < parser->input.string.current) {
+            /* The marker is already read */
+            parser->raw_buffer.pointer += line - raw;
+        } else {
+            /* Restart reading from the marker */
+            parser->input.string.current = line;
+            parser->raw_buffer.pointer = parser->raw_buffer.start;
+            parser->raw_buffer.last = parser->raw_buffer.start;
+            parser->eof = 0;
+        }
+        parser->offset = line - parser->input.string.start;
+    }
+    parser->mark = mark;
+    parser->simple_key_allowed = 1;
+
+    /* Same as libyaml on an empty document */
+    parser->state = *(--parser->states.top);
+    return true;
+}
 
 bool
 yaml_parser_skip(yaml_parser_t *parser, yaml_event_type_t last)
@@ -60,458 +272,1885 @@ yaml_parser_skip(yaml_parser_t *parser, yaml_event_type_t last)
     return true;
 }
 
-enum yaml_type {
-    /* Collection types */
-    YT_MAP,
-    YT_OMAP,
-    YT_PAIRS,
-    YT_SET,
-    YT_SEQ,
-
-    /* Scalar types */
-    YT_BINARY,
-    YT_BOOL,
-    YT_FLOAT,
-    YT_INT,
-    YT_MERGE,
-    YT_NULL,
-    YT_STR,
-    YT_TIMESTAMP,
-    YT_VALUE,
-    YT_YAML,
-};
+bool
+yaml_parser_skip_document_unchecked(yaml_parser_t *parser)
+{
+    yaml_event_t event;
 
-static enum yaml_type __attribute__((pure))
-_yaml_tag2type(const char *tag)
+    if (!libyaml_internals_checked() || !skip_document_content(parser))
+        return yaml_parser_skip(parser, YAML_DOCUMENT_START_EVENT);
+
+    if (!yaml_parser_parse(parser, &event))
+        return false;
+
+    assert(event.type == YAML_DOCUMENT_END_EVENT);
+    yaml_event_delete(&event);
+    return true;
+}
+
+static bool
+is_blank_line(const unsigned char *line, const unsigned char *end)
 {
-    switch (*tag++) {
-    case 'b': /* bool, binary */
-        switch (*tag++) {
-        case 'i': /* binary */
-            if (strcmp(tag, "nary"))
-                break;
-            return YT_BINARY;
-        case 'o': /* bool */
-            if (strcmp(tag, "ol"))
-                break;
-            return YT_BOOL;
+    while (line < end && (*line == ' ' || *line == '\t'))
+        line++;
+
+    return line == end || *line == '#' || line_break_width(line, end);
+}
+
+/* Look for the tag of the root node of a document on the line of its "---"
+ * marker, either before or after an anchor
+ */
+static const unsigned char *
+find_root_tag(const unsigned char *marker, const unsigned char *end,
+              size_t *length)
+{
+    const unsigned char *p = marker + 3;
+
+    for (int i = 0; i < 2; i++) {
+        const unsigned char *property;
+
+        while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+
+        property = p;
+        while (p < end && *p != ' ' && *p != '\t' && !line_break_width(p, end))
+            p++;
+
+        if (p == property)
+            return NULL;
+
+        if (*property == '!') {
+            *length = p - property;
+            return property;
         }
-        break;
-    case 'f': /* float */
-        if (strcmp(tag, "loat"))
-            break;
-        return YT_FLOAT;
-    case 'i': /* int */
-        if (strcmp(tag, "nt"))
-            break;
-        return YT_INT;
-    case 'm': /* map, merge */
-        switch (*tag++) {
-        case 'a': /* map */
-            if (strcmp(tag, "p"))
-                break;
-            return YT_MAP;
-        case 'e': /* merge */
-            if (strcmp(tag, "rge"))
-                break;
-            return YT_MERGE;
+
+        if (*property != '&')
+            return NULL;
+    }
+
+    return NULL;
+}
+
+bool
+yaml_index_documents(const char *input, size_t length,
+                     struct yaml_document_offset **documents, size_t *count)
+{
+    const unsigned char *start = (const unsigned char *)input;
+    const unsigned char *end = start + length;
+    struct yaml_document_offset *array = NULL;
+    const unsigned char *line = start;
+    const unsigned char *next = start;
+    size_t capacity = 0;
+    size_t size = 0;
+    /* Where the next document starts, if it does not start with "---" */
+    size_t offset = 0;
+    size_t number = 0;
+    bool in_document = false;
+
+    /* A byte order mark is not part of the first line */
+    if (length >= 3 && memcmp(input, "\xef\xbb\xbf", 3) == 0)
+        line += 3;
+
+    /* "---" and "..." at the start of a line always are document markers:
+     * the content of block scalars is indented, and flow scalars may not
+     * hold them.
+     */
+    for (size_t i = 0; next != NULL; line = next, i++) {
+        struct yaml_document_offset *document;
+        const unsigned char *tag;
+        size_t tag_length;
+        bool marker;
+
+        next = next_line(line, end);
+        marker = is_document_marker(line, end);
+
+        if (marker && line[0] == '.') {
+            in_document = false;
+            offset = next ? next - start : length;
+            number = i + 1;
+            continue;
         }
-        break;
-    case 'n': /* null */
-        if (strcmp(tag, "ull"))
-            break;
-        return YT_NULL;
-    case 'o': /* omap */
-        if (strcmp(tag, "map"))
-            break;
-        return YT_OMAP;
-    case 'p': /* pairs */
-        if (strcmp(tag, "airs"))
-            break;
-        return YT_PAIRS;
-    case 's': /* seq, set, str */
-        switch (*tag++) {
-        case 'e': /* seq, set */
-            switch (*tag++) {
-            case 'q': /* seq */
-                if (*tag != '\0')
-                    break;
-                return YT_SEQ;
-            case 't': /* set */
-                if (*tag != '\0')
-                    break;
-                return YT_SET;
+
+        if (!marker
+         && (in_document || is_blank_line(line, end) || line[0] == '%'))
+            continue;
+
+        /* A new document */
+        if (size == capacity) {
+            void *tmp;
+
+            capacity = capacity ? capacity * 2 : 64;
+            tmp = reallocarray(array, capacity, sizeof(*array));
+            if (tmp == NULL) {
+                free(array);
+                return false;
             }
-            break;
-        case 't': /* str */
-            if (strcmp(tag, "r"))
-                break;
-            return YT_STR;
+            array = tmp;
         }
-        break;
-    case 't': /* timestamp */
-        if (strcmp(tag, "imestamp"))
-            break;
-        return YT_TIMESTAMP;
-    case 'v': /* value */
-        if (strcmp(tag, "alue"))
+
+        document = &array[size++];
+        /* Comments and directives that precede "---" are part of it */
+        document->offset = in_document ? (size_t)(line - start) : offset;
+        document->line = in_document ? i : number;
+        document->tag_offset = 0;
+        document->tag_length = 0;
+
+        tag = marker ? find_root_tag(line, end, &tag_length) : NULL;
+        if (tag && tag - start - document->offset <= UINT32_MAX
+         && tag_length <= UINT32_MAX) {
+            document->tag_offset = tag - start - document->offset;
+            document->tag_length = tag_length;
+        }
+
+        in_document = true;
+    }
+
+    *documents = array;
+    *count = size;
+    return true;
+}
+
+bool
+yaml_parser_set_input_mmap(yaml_parser_t *parser, const char *path)
+{
+    struct stat st;
+    void *address;
+    FILE *file;
+    int save;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &st))
+        goto out_close;
+
+    if (S_ISDIR(st.st_mode)) {
+        errno = EISDIR;
+        goto out_close;
+    }
+
+    /* Pipes, sockets, ... cannot be mapped, and some regular files (eg. in
+     * /proc) claim to be empty when they are not
+     */
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        file = fdopen(fd, "r");
+        if (file == NULL)
+            goto out_close;
+
+        yaml_parser_set_input_file(parser, file);
+        return true;
+    }
+
+    if ((uintmax_t)st.st_size > SIZE_MAX) {
+        errno = EFBIG;
+        goto out_close;
+    }
+
+    address = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+        goto out_close;
+    close(fd);
+
+    /* Only hints, failures do not matter */
+    madvise(address, st.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(address, st.st_size, MADV_HUGEPAGE);
+#endif
+
+    yaml_parser_set_input_string(parser, address, st.st_size);
+    return true;
+
+out_close:
+    save = errno;
+    close(fd);
+    errno = save;
+    return false;
+}
+
+void
+yaml_parser_unset_input_mmap(yaml_parser_t *parser)
+{
+    if (reads_string(parser))
+        munmap((void *)parser->input.string.start,
+               parser->input.string.end - parser->input.string.start);
+    else
+        fclose(parser->input.file);
+}
+
+/* The state of yaml_parser_set_input_fd() and yaml_emitter_set_output_fd() */
+struct fd_stream {
+    int fd;
+    /* Regular files only (-1 otherwise): the offset of the next read */
+    off_t offset;
+    size_t size;
+    /* The bytes of buffer not yet handed to libyaml (input), or not yet
+     * written (output, start is unused)
+     */
+    size_t start;
+    size_t end;
+    unsigned char buffer[];
+};
+
+static struct fd_stream *
+fd_stream_new(int fd, size_t block_size)
+{
+    struct fd_stream *stream;
+
+    stream = malloc(sizeof(*stream) + block_size);
+    if (stream == NULL)
+        return NULL;
+
+    stream->fd = fd;
+    stream->offset = -1;
+    stream->size = block_size;
+    stream->start = 0;
+    stream->end = 0;
+    return stream;
+}
+
+static ssize_t
+read_block(struct fd_stream *stream, unsigned char *buffer, size_t size)
+{
+    ssize_t count;
+
+    do {
+        count = read(stream->fd, buffer, size);
+    } while (count < 0 && errno == EINTR);
+
+    if (count > 0 && stream->offset >= 0) {
+        stream->offset += count;
+        /* Have the kernel fetch the next block while this one is parsed */
+        posix_fadvise(stream->fd, stream->offset, size, POSIX_FADV_WILLNEED);
+    }
+    return count;
+}
+
+static int
+fd_read_handler(void *data, unsigned char *buffer, size_t size,
+                size_t *size_read)
+{
+    struct fd_stream *stream = data;
+    ssize_t count;
+
+    if (stream->start == stream->end) {
+        /* Large requests do not need to go through the block */
+        if (size >= stream->size) {
+            count = read_block(stream, buffer, size);
+            if (count < 0)
+                return 0;
+
+            *size_read = count;
+            return 1;
+        }
+
+        count = read_block(stream, stream->buffer, stream->size);
+        if (count < 0)
+            return 0;
+
+        stream->start = 0;
+        stream->end = count;
+    }
+
+    if (size > stream->end - stream->start)
+        size = stream->end - stream->start;
+
+    memcpy(buffer, stream->buffer + stream->start, size);
+    stream->start += size;
+    *size_read = size;
+    return 1;
+}
+
+bool
+yaml_parser_set_input_fd(yaml_parser_t *parser, int fd, size_t block_size)
+{
+    struct fd_stream *stream;
+    struct stat st;
+
+    stream = fd_stream_new(fd, block_size);
+    if (stream == NULL)
+        return false;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        stream->offset = lseek(fd, 0, SEEK_CUR);
+        /* Only hints, failures do not matter */
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        if (stream->offset >= 0 && block_size > 0)
+            posix_fadvise(fd, stream->offset, block_size,
+                          POSIX_FADV_WILLNEED);
+    }
+
+    yaml_parser_set_input(parser, fd_read_handler, stream);
+    return true;
+}
+
+void
+yaml_parser_unset_input_fd(yaml_parser_t *parser)
+{
+    free(parser->read_handler_data);
+}
+
+static bool
+write_all(int fd, const unsigned char *buffer, size_t size)
+{
+    while (size > 0) {
+        ssize_t count = write(fd, buffer, size);
+
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        buffer += count;
+        size -= count;
+    }
+
+    return true;
+}
+
+static int
+fd_write_handler(void *data, unsigned char *buffer, size_t size)
+{
+    struct fd_stream *stream = data;
+
+    if (stream->end + size > stream->size) {
+        if (!write_all(stream->fd, stream->buffer, stream->end))
+            return 0;
+        stream->end = 0;
+    }
+
+    /* Large writes do not need to go through the block */
+    if (size >= stream->size)
+        return write_all(stream->fd, buffer, size);
+
+    memcpy(stream->buffer + stream->end, buffer, size);
+    stream->end += size;
+    return 1;
+}
+
+bool
+yaml_emitter_set_output_fd(yaml_emitter_t *emitter, int fd, size_t block_size)
+{
+    struct fd_stream *stream;
+
+    stream = fd_stream_new(fd, block_size);
+    if (stream == NULL)
+        return false;
+
+    yaml_emitter_set_output(emitter, fd_write_handler, stream);
+    return true;
+}
+
+bool
+yaml_emitter_unset_output_fd(yaml_emitter_t *emitter)
+{
+    struct fd_stream *stream = emitter->write_handler_data;
+    bool success;
+
+    success = yaml_emitter_flush(emitter)
+           && write_all(stream->fd, stream->buffer, stream->end);
+    free(stream);
+    return success;
+}
+
+/* Types of the YAML tag repository (https://yaml.org/type/), indexed by
+ * type_hash() of their name
+ *
+ * type_hash() was chosen so that no two names collide: resolving a tag costs a
+ * hash and a single comparison.
+ */
+#define TYPE_HASH_SIZE 32
+
+static inline unsigned int
+type_hash(const char *name, size_t length)
+{
+    return (length + (unsigned char)name[1] + (unsigned char)name[2] * 4)
+         % TYPE_HASH_SIZE;
+}
+
+static const struct {
+    char name[sizeof("timestamp")];
+    unsigned char length;
+    enum yaml_type type;
+} YAML_TYPES[TYPE_HASH_SIZE] = {
+    [1] = { "int", 3, YT_INT },
+    [4] = { "map", 3, YT_MAP },
+    [6] = { "timestamp", 9, YT_TIMESTAMP },
+    [7] = { "binary", 6, YT_BINARY },
+    [9] = { "null", 4, YT_NULL },
+    [10] = { "pairs", 5, YT_PAIRS },
+    [12] = { "seq", 3, YT_SEQ },
+    [13] = { "float", 5, YT_FLOAT },
+    [15] = { "bool", 4, YT_BOOL },
+    [18] = { "merge", 5, YT_MERGE },
+    [21] = { "omap", 4, YT_OMAP },
+    [22] = { "value", 5, YT_VALUE },
+    [24] = { "set", 3, YT_SET },
+    [25] = { "yaml", 4, YT_YAML },
+    [31] = { "str", 3, YT_STR },
+};
+
+static enum yaml_type __attribute__((pure))
+_yaml_tag2type(const char *name, size_t length)
+{
+    unsigned int hash;
+
+    /* Every name is 3 to 9 characters long */
+    if (length < 3 || length >= sizeof(YAML_TYPES[0].name))
+        goto out_einval;
+
+    hash = type_hash(name, length);
+    if (YAML_TYPES[hash].length != length
+     || memcmp(YAML_TYPES[hash].name, name, length))
+        goto out_einval;
+
+    return YAML_TYPES[hash].type;
+
+out_einval:
+    errno = EINVAL;
+    return YT_UNKNOWN;
+}
+
+#define YAML_TAG_PREFIX "tag:yaml.org,2002:"
+
+enum yaml_type
+yaml_tag2type_n(const char *tag, size_t length)
+{
+    const size_t prefix = sizeof(YAML_TAG_PREFIX) - 1;
+
+    if (length >= prefix && memcmp(tag, YAML_TAG_PREFIX, prefix) == 0)
+        return _yaml_tag2type(tag + prefix, length - prefix);
+
+    /* Shorthand (libyaml expands it, but users may not) */
+    if (length >= 2 && tag[0] == '!' && tag[1] == '!')
+        return _yaml_tag2type(tag + 2, length - 2);
+
+    /* Local tag */
+    errno = ENOTSUP;
+    return YT_UNKNOWN;
+}
+
+enum yaml_type
+yaml_tag2type(const char *tag)
+{
+    return yaml_tag2type_n(tag, strlen(tag));
+}
+
+/* Keywords are at most 8 characters long: they are compared as 64-bit integers
+ * (first character in the least significant byte, unused bytes set to zero).
+ */
+
+#define KEYWORD_MAX_LENGTH 8
+
+#define K1(a) ((uint64_t)(a))
+#define K2(a, b) (K1(a) | (uint64_t)(b) << 8)
+#define K3(a, b, c) (K2(a, b) | (uint64_t)(c) << 16)
+#define K4(a, b, c, d) (K3(a, b, c) | (uint64_t)(d) << 24)
+#define K5(a, b, c, d, e) (K4(a, b, c, d) | (uint64_t)(e) << 32)
+
+static inline uint64_t
+load_keyword(const char *s, size_t length)
+{
+    uint64_t word = 0;
+
+    memcpy(&word, s, length);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/* Set every letter of \p word to lower case
+ *
+ * Return false if \p word is not in one of the spellings YAML allows for
+ * keywords: lower case (true), capitalized (True), or upper case (TRUE).
+ */
+static inline bool
+fold_keyword(uint64_t *word)
+{
+    const uint64_t ascii = ~*word & BYTES(0x80);
+    const uint64_t heptets = *word & BYTES(0x7f);
+    uint64_t upper, lower;
+
+    /* The high bit of each byte is set if the byte is in the range */
+    upper = (heptets + BYTES(0x80 - 'A')) & ~(heptets + BYTES(0x80 - 'Z' - 1))
+          & ascii;
+    lower = (heptets + BYTES(0x80 - 'a')) & ~(heptets + BYTES(0x80 - 'z' - 1))
+          & ascii;
+
+    /* Mixed case, but not capitalized */
+    if (upper && lower && upper != 0x80)
+        return false;
+
+    *word |= upper >> 2;
+    return true;
+}
+
+bool
+yaml_scalar_match(const yaml_event_t *event,
+                  const struct yaml_keyword *keywords, size_t count,
+                  bool fold_case, int *value)
+{
+    size_t length = yaml_scalar_length(event);
+    uint64_t word;
+
+    if (length > KEYWORD_MAX_LENGTH)
+        goto out_einval;
+
+    word = load_keyword(yaml_scalar_value(event), length);
+    if (fold_case && !fold_keyword(&word))
+        goto out_einval;
+
+    for (size_t i = 0; i < count; i++) {
+        if (strnlen(keywords[i].name, KEYWORD_MAX_LENGTH + 1) != length)
+            continue;
+
+        if (load_keyword(keywords[i].name, length) == word) {
+            *value = keywords[i].value;
+            return true;
+        }
+    }
+
+out_einval:
+    errno = EINVAL;
+    return false;
+}
+
+/* Return whether the \p length characters at \p value spell null */
+static bool
+match_null(const char *value, size_t length)
+{
+    uint64_t word;
+
+    switch (length) {
+    case 0: /* (empty) */
+        return true;
+    case 1: /* ~ */
+        return *value == '~';
+    case 4: /* null, Null, NULL */
+        word = load_keyword(value, length);
+        return fold_keyword(&word) && word == K4('n', 'u', 'l', 'l');
+    }
+
+    return false;
+}
+
+/* Return whether the \p length characters at \p value spell a boolean
+ *
+ * YAML 1.2 only knows of true and false, YAML 1.1 also has y, n, yes, no, on
+ * and off.
+ */
+static bool
+match_boolean(const char *value, size_t length, bool yaml_1_1, bool *b)
+{
+    uint64_t word;
+
+    if (length > KEYWORD_MAX_LENGTH)
+        return false;
+
+    word = load_keyword(value, length);
+    if (!fold_keyword(&word))
+        return false;
+
+    switch (length) {
+    case 1:
+        if (!yaml_1_1)
+            break;
+        if (word == K1('y')) {
+            *b = true;
+            return true;
+        }
+        if (word == K1('n')) {
+            *b = false;
+            return true;
+        }
+        break;
+    case 2:
+        if (!yaml_1_1)
+            break;
+        if (word == K2('o', 'n')) {
+            *b = true;
+            return true;
+        }
+        if (word == K2('n', 'o')) {
+            *b = false;
+            return true;
+        }
+        break;
+    case 3:
+        if (!yaml_1_1)
+            break;
+        if (word == K3('y', 'e', 's')) {
+            *b = true;
+            return true;
+        }
+        if (word == K3('o', 'f', 'f')) {
+            *b = false;
+            return true;
+        }
+        break;
+    case 4:
+        if (word == K4('t', 'r', 'u', 'e')) {
+            *b = true;
+            return true;
+        }
+        break;
+    case 5:
+        if (word == K5('f', 'a', 'l', 's', 'e')) {
+            *b = false;
+            return true;
+        }
+        break;
+    }
+
+    return false;
+}
+
+/* Return whether a scalar's tag (or lack thereof) allows it to be of \p type */
+static bool
+is_of_type(yaml_scalar_style_t style, const char *tag, enum yaml_type type)
+{
+    if (tag ? yaml_tag2type(tag) != type : style != YAML_PLAIN_SCALAR_STYLE) {
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+bool
+yaml_parse_null_n(const char *value, size_t length, yaml_scalar_style_t style,
+                  const char *tag)
+{
+    if (tag) {
+        errno = EINVAL;
+        return yaml_tag2type(tag) == YT_NULL;
+    }
+
+    if (style != YAML_PLAIN_SCALAR_STYLE || !match_null(value, length)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return true;
+}
+
+bool
+yaml_parse_null(const yaml_event_t *event)
+{
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    return yaml_parse_null_n(yaml_scalar_value(event),
+                             yaml_scalar_length(event),
+                             yaml_scalar_style(event), yaml_scalar_tag(event));
+}
+
+bool
+yaml_parse_boolean_n(const char *value, size_t length,
+                     yaml_scalar_style_t style, const char *tag, bool *b)
+{
+    if (!is_of_type(style, tag, YT_BOOL))
+        return false;
+
+    if (!match_boolean(value, length, true, b)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return true;
+}
+
+bool
+yaml_parse_boolean(const yaml_event_t *event, bool *b)
+{
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    return yaml_parse_boolean_n(yaml_scalar_value(event),
+                                yaml_scalar_length(event),
+                                yaml_scalar_style(event),
+                                yaml_scalar_tag(event), b);
+}
+
+static const char DIGIT_PAIRS[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Write the decimal representation of \p u right before \p end, two digits at
+ * a time, and return a pointer to its first character
+ */
+static char *
+format_unsigned(char *end, uintmax_t u)
+{
+    while (u >= 100) {
+        unsigned int pair = u % 100;
+
+        u /= 100;
+        end -= 2;
+        memcpy(end, &DIGIT_PAIRS[pair * 2], 2);
+    }
+
+    if (u >= 10) {
+        end -= 2;
+        memcpy(end, &DIGIT_PAIRS[u * 2], 2);
+    } else {
+        *--end = '0' + u;
+    }
+
+    return end;
+}
+
+bool
+yaml_emit_integer(yaml_emitter_t *emitter, intmax_t i)
+{
+    char buffer[sizeof(i) * 3 + 1];
+    char *end = buffer + sizeof(buffer);
+    char *start;
+
+    /* -INTMAX_MIN does not fit in an intmax_t, but it does in an uintmax_t */
+    start = format_unsigned(end, i < 0 ? -(uintmax_t)i : (uintmax_t)i);
+    if (i < 0)
+        *--start = '-';
+
+    return yaml_emit_scalar(emitter, NULL, start, end - start,
+                            YAML_PLAIN_SCALAR_STYLE);
+}
+
+bool
+yaml_emit_unsigned_integer(yaml_emitter_t *emitter, uintmax_t u)
+{
+    char buffer[sizeof(u) * 3];
+    char *end = buffer + sizeof(buffer);
+    char *start;
+
+    start = format_unsigned(end, u);
+    return yaml_emit_scalar(emitter, NULL, start, end - start,
+                            YAML_PLAIN_SCALAR_STYLE);
+}
+
+/* Return true if the 8 characters at \p s are all decimal digits, and set
+ * \p value to the number they represent
+ */
+static inline bool
+parse_8_digits(const char *s, uint64_t *value)
+{
+    uint64_t chunk;
+
+    memcpy(&chunk, s, sizeof(chunk));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    chunk = __builtin_bswap64(chunk);
+#endif
+
+    /* Every byte is in '0' ... '9' */
+    if ((chunk & 0xf0f0f0f0f0f0f0f0) != 0x3030303030303030
+     || ((chunk + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0)
+            != 0x3030303030303030)
+        return false;
+
+    /* Combine digits pairwise: 8 x 1 digit -> 4 x 2 digits -> 1 x 8 digits */
+    chunk -= 0x3030303030303030;
+    chunk = chunk * 10 + (chunk >> 8);
+    chunk = ((chunk & 0x000000ff000000ff) * (100 + (1000000ULL << 32))
+           + (chunk >> 16 & 0x000000ff000000ff) * (1 + (10000ULL << 32)))
+         >> 32;
+
+    *value = chunk;
+    return true;
+}
+
+static inline unsigned int
+digit_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return UINT_MAX;
+}
+
+/* Parse \p value as an integer (YAML 1.1 and 1.2)
+ *
+ * [-+]?0b[01_]+, [-+]?0o?[0-7_]+, [-+]?0[xX][0-9a-fA-F_]+,
+ * or [-+]?[1-9][0-9_]*
+ *
+ * (strtoimax(), which this replaces, accepted "0X" too)
+ *
+ * \p magnitude is set to the absolute value of the integer, which must not
+ * exceed \p max_positive (or \p max_negative if the integer is negative).
+ *
+ * errno is only set on error: EINVAL if \p value is not an integer, ERANGE if
+ * its magnitude is out of bounds.
+ */
+static bool
+parse_integer(const char *value, size_t length, uintmax_t max_positive,
+              uintmax_t max_negative, bool *negative, uintmax_t *magnitude)
+{
+    const char *end = value + length;
+    unsigned int base = 10;
+    bool overflow = false;
+    bool digits = false;
+    uintmax_t u = 0;
+    uintmax_t max;
+
+    *negative = false;
+    if (value < end && (*value == '-' || *value == '+'))
+        *negative = *value++ == '-';
+    max = *negative ? max_negative : max_positive;
+
+    if (end - value >= 2 && value[0] == '0') {
+        switch (value[1]) {
+        case 'b':
+            base = 2;
+            value += 2;
+            break;
+        case 'o':
+            base = 8;
+            value += 2;
+            break;
+        case 'x':
+        case 'X':
+            base = 16;
+            value += 2;
+            break;
+        default: /* C-style octal (YAML 1.1) */
+            base = 8;
+            value++;
+            digits = true;
+            break;
+        }
+    }
+
+    while (value < end) {
+        unsigned int digit;
+        uint64_t chunk;
+
+        if (base == 10 && end - value >= 8 && parse_8_digits(value, &chunk)) {
+            overflow |= __builtin_mul_overflow(u, 100000000, &u)
+                      | __builtin_add_overflow(u, chunk, &u)
+                      | (u > max);
+            value += 8;
+            digits = true;
+            continue;
+        }
+
+        /* Decimal integers cannot start with '_' */
+        if (*value == '_' && (digits || base != 10)) {
+            value++;
+            continue;
+        }
+
+        digit = digit_value(*value++);
+        if (digit >= base)
+            goto out_einval;
+
+        overflow |= __builtin_mul_overflow(u, base, &u)
+                  | __builtin_add_overflow(u, digit, &u)
+                  | (u > max);
+        digits = true;
+    }
+
+    if (!digits)
+        goto out_einval;
+
+    if (overflow) {
+        errno = ERANGE;
+        return false;
+    }
+
+    *magnitude = u;
+    return true;
+
+out_einval:
+    errno = EINVAL;
+    return false;
+}
+
+/* Check \p event is an integer and parse it with parse_integer() */
+static bool
+parse_integer_event(const yaml_event_t *event, uintmax_t max_positive,
+                    uintmax_t max_negative, bool *negative,
+                    uintmax_t *magnitude)
+{
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    if (!is_of_type(yaml_scalar_style(event), yaml_scalar_tag(event), YT_INT))
+        return false;
+
+    return parse_integer(yaml_scalar_value(event), yaml_scalar_length(event),
+                         max_positive, max_negative, negative, magnitude);
+}
+
+/* -(max + 1) cannot be computed as a signed integer of the same width */
+#define SIGNED_VALUE(type, negative, magnitude) \
+    ((negative) && (magnitude) ? -(type)((magnitude) - 1) - 1 \
+                               : (type)(magnitude))
+
+bool
+yaml_parse_integer_n(const char *value, size_t length,
+                     yaml_scalar_style_t style, const char *tag, intmax_t *i)
+{
+    uintmax_t magnitude;
+    bool negative;
+
+    if (!is_of_type(style, tag, YT_INT))
+        return false;
+
+    if (!parse_integer(value, length, INTMAX_MAX, (uintmax_t)INTMAX_MAX + 1,
+                       &negative, &magnitude))
+        return false;
+
+    *i = SIGNED_VALUE(intmax_t, negative, magnitude);
+    return true;
+}
+
+bool
+yaml_parse_integer(const yaml_event_t *event, intmax_t *i)
+{
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    return yaml_parse_integer_n(yaml_scalar_value(event),
+                                yaml_scalar_length(event),
+                                yaml_scalar_style(event),
+                                yaml_scalar_tag(event), i);
+}
+
+bool
+yaml_parse_unsigned_integer_n(const char *value, size_t length,
+                              yaml_scalar_style_t style, const char *tag,
+                              uintmax_t *u)
+{
+    uintmax_t magnitude;
+    bool negative;
+
+    if (!is_of_type(style, tag, YT_INT))
+        return false;
+
+    if (!parse_integer(value, length, UINTMAX_MAX, UINTMAX_MAX, &negative,
+                       &magnitude))
+        return false;
+
+    /* Same as strtoumax() */
+    *u = negative ? -magnitude : magnitude;
+    return true;
+}
+
+bool
+yaml_parse_unsigned_integer(const yaml_event_t *event, uintmax_t *u)
+{
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    return yaml_parse_unsigned_integer_n(yaml_scalar_value(event),
+                                         yaml_scalar_length(event),
+                                         yaml_scalar_style(event),
+                                         yaml_scalar_tag(event), u);
+}
+
+/* The range of the destination type is checked digit by digit, as the value is
+ * parsed
+ */
+#define DEFINE_PARSE_INT(bits) \
+bool \
+yaml_parse_int ## bits(const yaml_event_t *event, int ## bits ## _t *i) \
+{ \
+    uintmax_t magnitude; \
+    bool negative; \
+ \
+    if (!parse_integer_event(event, INT ## bits ## _MAX, \
+                             (uintmax_t)INT ## bits ## _MAX + 1, &negative, \
+                             &magnitude)) \
+        return false; \
+ \
+    *i = SIGNED_VALUE(int ## bits ## _t, negative, magnitude); \
+    return true; \
+}
+
+#define DEFINE_PARSE_UINT(bits) \
+bool \
+yaml_parse_uint ## bits(const yaml_event_t *event, uint ## bits ## _t *u) \
+{ \
+    uintmax_t magnitude; \
+    bool negative; \
+ \
+    /* Only "-0" is a valid negative value */ \
+    if (!parse_integer_event(event, UINT ## bits ## _MAX, 0, &negative, \
+                             &magnitude)) \
+        return false; \
+ \
+    *u = magnitude; \
+    return true; \
+}
+
+DEFINE_PARSE_INT(8)
+DEFINE_PARSE_INT(16)
+DEFINE_PARSE_INT(32)
+DEFINE_PARSE_INT(64)
+
+DEFINE_PARSE_UINT(8)
+DEFINE_PARSE_UINT(16)
+DEFINE_PARSE_UINT(32)
+DEFINE_PARSE_UINT(64)
+
+bool
+yaml_emit_float(yaml_emitter_t *emitter, double d)
+{
+    char buffer[FLOAT_FORMAT_SIZE];
+    size_t length;
+
+    length = float_format(buffer, d);
+    return yaml_emit_scalar(emitter, NULL, buffer, length,
+                            YAML_PLAIN_SCALAR_STYLE);
+}
+
+bool
+yaml_parse_float(const yaml_event_t *event, double *d)
+{
+    const char *value = yaml_scalar_value(event);
+    const char *tag = yaml_scalar_tag(event);
+
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    if (tag ? yaml_tag2type(tag) != YT_FLOAT : !yaml_scalar_is_plain(event)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return float_parse(value, event->data.scalar.length, d);
+}
+
+bool
+yaml_emit_timestamp(yaml_emitter_t *emitter, struct timespec ts)
+{
+    char buffer[TIMESTAMP_FORMAT_SIZE];
+    size_t length;
+
+    length = timestamp_format(buffer, &ts);
+    if (length == 0)
+        return false;
+
+    return yaml_emit_scalar(emitter, NULL, buffer, length,
+                            YAML_PLAIN_SCALAR_STYLE);
+}
+
+bool
+yaml_parse_timestamp(const yaml_event_t *event, struct timespec *ts)
+{
+    const char *value = yaml_scalar_value(event);
+    const char *tag = yaml_scalar_tag(event);
+
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    if (tag ? yaml_tag2type(tag) != YT_TIMESTAMP
+            : !yaml_scalar_is_plain(event)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return timestamp_parse(value, event->data.scalar.length, ts);
+}
+
+bool
+yaml_parse_string_n(const char *value, size_t length,
+                    yaml_scalar_style_t style, const char *tag,
+                    const char **string, size_t *string_length)
+{
+    if (tag && yaml_tag2type(tag) != YT_STR) {
+        errno = EINVAL;
+        return false;
+    }
+
+    *string = value;
+    if (string_length)
+        *string_length = length;
+    return true;
+}
+
+bool
+yaml_parse_string(const yaml_event_t *event, const char **string,
+                  size_t *length)
+{
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    return yaml_parse_string_n(yaml_scalar_value(event),
+                               yaml_scalar_length(event),
+                               yaml_scalar_style(event),
+                               yaml_scalar_tag(event), string, length);
+}
+
+/* States of the automaton that tells numbers apart from other plain scalars */
+enum number_state {
+    NS_START,
+    NS_SIGN,
+    NS_ZERO,        /* 0 */
+    NS_DECIMAL,     /* 12 (or 012) */
+    NS_DOT,         /* . (or +.) */
+    NS_FRACTION,    /* 1.2, 1. or .2 */
+    NS_EXP_START,   /* 1.2e */
+    NS_EXP_SIGN,    /* 1.2e- */
+    NS_EXPONENT,    /* 1.2e-3 */
+    NS_BASE,        /* 0b, 0o or 0x */
+    NS_DIGITS,      /* 0b1, 0o7 or 0xf */
+    /* Final states */
+    NS_SPECIAL,     /* .inf or .nan, maybe */
+    NS_TIMESTAMP,   /* 2001-, maybe */
+    NS_STRING,
+};
+
+/* Classify a plain scalar as an integer, a float, a timestamp or a string, in a
+ * single pass over \p value
+ *
+ * Only the syntax is checked, values are decoded afterwards (decoding can still
+ * fail, in which case the scalar is a string after all).
+ */
+static enum yaml_type
+classify_number(const char *value, size_t length, bool yaml_1_1,
+                bool *leading_zero)
+{
+    enum number_state state = NS_START;
+    unsigned int base = 10;
+    bool sign = false;
+
+    *leading_zero = false;
+
+    for (size_t i = 0; i < length && state < NS_SPECIAL; i++) {
+        const char c = value[i];
+
+        switch (state) {
+        case NS_START:
+        case NS_SIGN:
+            if (state == NS_START && (c == '-' || c == '+')) {
+                state = NS_SIGN;
+                sign = true;
+            } else if (c == '0') {
+                state = NS_ZERO;
+            } else if (c >= '1' && c <= '9') {
+                state = NS_DECIMAL;
+            } else if (c == '.') {
+                state = NS_DOT;
+            } else {
+                state = NS_STRING;
+            }
+            break;
+        case NS_ZERO:
+            /* YAML 1.1: 0b and 0x, YAML 1.2: unsigned 0o and 0x */
+            if ((c == 'b' && yaml_1_1) || (c == 'o' && !yaml_1_1 && !sign)
+             || (c == 'x' && (yaml_1_1 || !sign))) {
+                base = c == 'b' ? 2 : c == 'o' ? 8 : 16;
+                state = NS_BASE;
+                break;
+            }
+            if ((c >= '0' && c <= '9') || (c == '_' && yaml_1_1)) {
+                *leading_zero = true;
+                state = NS_DECIMAL;
+                break;
+            }
+            /* fall through */
+        case NS_DECIMAL:
+            if ((c >= '0' && c <= '9') || (c == '_' && yaml_1_1))
+                break;
+            if (c == '.')
+                state = NS_FRACTION;
+            /* YAML 1.1 floats must have a dot */
+            else if ((c == 'e' || c == 'E') && !yaml_1_1)
+                state = NS_EXP_START;
+            /* YAML 1.1 timestamps start with a 4-digit year */
+            else if (c == '-' && yaml_1_1 && i == 4 && !sign)
+                state = NS_TIMESTAMP;
+            else
+                state = NS_STRING;
+            break;
+        case NS_DOT:
+            if (c >= '0' && c <= '9')
+                state = NS_FRACTION;
+            else if (c == 'i' || c == 'I' || c == 'n' || c == 'N')
+                state = NS_SPECIAL;
+            else
+                state = NS_STRING;
+            break;
+        case NS_FRACTION:
+            if ((c >= '0' && c <= '9') || (c == '_' && yaml_1_1))
+                break;
+            state = c == 'e' || c == 'E' ? NS_EXP_START : NS_STRING;
+            break;
+        case NS_EXP_START:
+            if (c == '-' || c == '+')
+                state = NS_EXP_SIGN;
+            /* YAML 1.1 exponents must be signed */
+            else if (c >= '0' && c <= '9' && !yaml_1_1)
+                state = NS_EXPONENT;
+            else
+                state = NS_STRING;
+            break;
+        case NS_EXP_SIGN:
+        case NS_EXPONENT:
+            state = c >= '0' && c <= '9' ? NS_EXPONENT : NS_STRING;
+            break;
+        case NS_BASE:
+        case NS_DIGITS:
+            if (c == '_' && yaml_1_1)
+                break;
+            state = digit_value(c) < base ? NS_DIGITS : NS_STRING;
+            break;
+        default:
+            __builtin_unreachable();
+        }
+    }
+
+    switch (state) {
+    case NS_ZERO:
+    case NS_DECIMAL:
+    case NS_DIGITS:
+        return YT_INT;
+    case NS_FRACTION:
+    case NS_EXPONENT:
+    case NS_SPECIAL:
+        return YT_FLOAT;
+    case NS_TIMESTAMP:
+        return YT_TIMESTAMP;
+    default:
+        return YT_STR;
+    }
+}
+
+static bool
+scalar_integer(const char *value, size_t length, intmax_t *i)
+{
+    uintmax_t magnitude;
+    bool negative;
+
+    if (!parse_integer(value, length, INTMAX_MAX, (uintmax_t)INTMAX_MAX + 1,
+                       &negative, &magnitude))
+        return false;
+
+    *i = SIGNED_VALUE(intmax_t, negative, magnitude);
+    return true;
+}
+
+/* YAML 1.2 decimal integers may have leading zeros (parse_integer() would
+ * parse them as octal integers)
+ */
+static bool
+scalar_decimal_integer(const char *value, size_t length, intmax_t *i)
+{
+    const char *end = value + length;
+    uintmax_t magnitude;
+    bool negative = false;
+    bool unused;
+
+    if (*value == '-' || *value == '+')
+        negative = *value++ == '-';
+    while (end - value > 1 && *value == '0')
+        value++;
+
+    if (!parse_integer(value, end - value, (uintmax_t)INTMAX_MAX + negative,
+                       0, &unused, &magnitude))
+        return false;
+
+    *i = SIGNED_VALUE(intmax_t, negative, magnitude);
+    return true;
+}
+
+/* Parse \p value as the core schema resolves plain integers */
+static bool
+scalar_core_integer(const char *value, size_t length, intmax_t *i)
+{
+    bool leading_zero;
+
+    if (classify_number(value, length, false, &leading_zero) != YT_INT) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (leading_zero)
+        return scalar_decimal_integer(value, length, i);
+    return scalar_integer(value, length, i);
+}
+
+/* Resolve the type of a plain scalar without a tag */
+static bool
+parse_plain_scalar(const char *value, size_t length, bool yaml_1_1,
+                   struct yaml_scalar *scalar)
+{
+    bool leading_zero;
+    bool success;
+
+    if (match_null(value, length)) {
+        scalar->type = YT_NULL;
+        return true;
+    }
+
+    if (match_boolean(value, length, yaml_1_1, &scalar->value.b)) {
+        scalar->type = YT_BOOL;
+        return true;
+    }
+
+    scalar->type = classify_number(value, length, yaml_1_1, &leading_zero);
+    switch (scalar->type) {
+    case YT_INT:
+        if (leading_zero && !yaml_1_1)
+            success = scalar_decimal_integer(value, length, &scalar->value.i);
+        else
+            success = scalar_integer(value, length, &scalar->value.i);
+        break;
+    case YT_FLOAT:
+        success = float_parse(value, length, &scalar->value.d);
+        break;
+    case YT_TIMESTAMP:
+        success = timestamp_parse(value, length, &scalar->value.ts);
+        break;
+    default:
+        success = false;
+        errno = EINVAL;
+        break;
+    }
+
+    if (success || errno != EINVAL)
+        return success;
+
+    /* Looked like something else, but is not */
+    scalar->type = YT_STR;
+    scalar->value.string.value = value;
+    scalar->value.string.length = length;
+    return true;
+}
+
+bool
+yaml_parse_scalar_auto(const yaml_event_t *event, enum yaml_schema schema,
+                       struct yaml_scalar *scalar)
+{
+    const char *value = yaml_scalar_value(event);
+    size_t length = yaml_scalar_length(event);
+    const char *tag = yaml_scalar_tag(event);
+    bool yaml_1_1 = schema == YAML_SCHEMA_1_1;
+    struct yaml_scalar result;
+    int saved_errno = errno;
+
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    if (tag == NULL && yaml_scalar_is_plain(event)) {
+        if (!parse_plain_scalar(value, length, yaml_1_1, &result))
+            return false;
+
+        /* Failed attempts at decoding the scalar must not show */
+        errno = saved_errno;
+        *scalar = result;
+        return true;
+    }
+
+    /* The non-specific tag "!" forces a scalar to be a string */
+    result.type = tag && strcmp(tag, "!") ? yaml_tag2type(tag) : YT_STR;
+    switch (result.type) {
+    case YT_NULL:
+        break;
+    case YT_BOOL:
+        if (!match_boolean(value, length, yaml_1_1, &result.value.b)) {
+            errno = EINVAL;
+            return false;
+        }
+        break;
+    case YT_INT:
+        /* The core schema has the same rules for integers, tagged or not */
+        if (!(yaml_1_1 ? scalar_integer(value, length, &result.value.i)
+                       : scalar_core_integer(value, length, &result.value.i)))
+            return false;
+        break;
+    case YT_FLOAT:
+        if (!float_parse(value, length, &result.value.d))
+            return false;
+        break;
+    case YT_TIMESTAMP:
+        if (!timestamp_parse(value, length, &result.value.ts))
+            return false;
+        break;
+    case YT_STR:
+        result.value.string.value = value;
+        result.value.string.length = length;
+        break;
+    default:
+        errno = ENOTSUP;
+        return false;
+    }
+
+    *scalar = result;
+    return true;
+}
+
+#ifndef YAML_BINARY_TAG
+# define YAML_BINARY_TAG "tag:yaml.org,2002:binary"
+#endif
+
+static bool
+_yaml_emit_binary(yaml_emitter_t *emitter, const char *b64, size_t size)
+{
+    return yaml_emit_scalar(emitter, YAML_BINARY_TAG, b64, size,
+                            YAML_ANY_SCALAR_STYLE);
+}
+
+bool
+yaml_emit_binary(yaml_emitter_t *emitter, const char *data, size_t size)
+{
+    char onstack[256];
+    char *buffer = onstack;
+    bool success;
+
+    /* Encoding in base64 increases the size by a factor of 4/3
+     *                     vvvv      vvvvvvv
+     */
+    if (sizeof(onstack) < (size + 2) * 4 / 3 + 1) {
+        /*                      ^^^          ^^^
+         * Account for padding bytes   and   the terminating null byte
+         */
+        buffer = malloc((size + 2) * 4 / 3 + 1);
+        if (buffer == NULL)
+            return false;
+    }
+
+    size = base64_encode(buffer, data, size);
+    success = _yaml_emit_binary(emitter, buffer, size);
+    if (buffer != onstack)
+        free(buffer);
+    return success;
+}
+
+void
+yaml_scratch_delete(yaml_scratch_t *scratch)
+{
+    free(scratch->data);
+    *scratch = (yaml_scratch_t){};
+}
+
+static bool
+scratch_reserve(yaml_scratch_t *scratch, size_t size)
+{
+    size_t capacity = scratch->size ? scratch->size : 256;
+    char *data;
+
+    if (size <= scratch->size)
+        return true;
+
+    while (capacity < size)
+        capacity = capacity * 2 > capacity ? capacity * 2 : size;
+
+    data = realloc(scratch->data, capacity);
+    if (data == NULL)
+        return false;
+
+    scratch->data = data;
+    scratch->size = capacity;
+    return true;
+}
+
+bool
+yaml_emit_binary_scratch(yaml_emitter_t *emitter, const char *data,
+                         size_t size, yaml_scratch_t *scratch)
+{
+    /* Account for padding bytes and the terminating null byte */
+    if (!scratch_reserve(scratch, (size + 2) / 3 * 4 + 1))
+        return false;
+
+    size = base64_encode(scratch->data, data, size);
+    return _yaml_emit_binary(emitter, scratch->data, size);
+}
+
+/* Number of bytes encoded on each line of a streamed binary scalar (the
+ * resulting lines are 76 characters long, as in RFC2045)
+ */
+#define BINARY_LINE_BYTES 57
+#define BINARY_LINE_WIDTH 76
+
+/* yaml_emit_binary_stream() reaches into members of yaml_emitter_t that libyaml
+ * documents as internal: its queue of events, its indentation, its output
+ * buffer and its write handler. What follows was checked against libyaml 0.2.5
+ * (see libyaml_internals_checked()).
+ */
+
+/* Whether one of the collections libyaml has yet to process is a flow one */
+static bool
+emitter_queues_flow(const yaml_emitter_t *emitter)
+{
+    for (const yaml_event_t *event = emitter->events.head;
+         event != emitter->events.tail; event++) {
+        switch (event->type) {
+        case YAML_SEQUENCE_START_EVENT:
+            if (event->data.sequence_start.style == YAML_FLOW_SEQUENCE_STYLE)
+                return true;
+            break;
+        case YAML_MAPPING_START_EVENT:
+            if (event->data.mapping_start.style == YAML_FLOW_MAPPING_STYLE)
+                return true;
             break;
-        return YT_VALUE;
-    case 'y': /* yaml */
-        if (strcmp(tag, "aml"))
+        default:
             break;
-        return YT_YAML;
+        }
     }
-
-    errno = EINVAL;
-    return -1;
+    return false;
 }
 
-static enum yaml_type
-yaml_tag2type(const char *tag)
+/* libyaml keeps the first events of a collection queued until it has seen
+ * enough of them to decide how to emit it. Nothing it decides this way depends
+ * on the events that follow a scalar, so appending dummy events, and dropping
+ * them as soon as the scalar is processed, is harmless.
+ *
+ * Dummy events are collection starts: they always stay queued.
+ */
+static bool
+emitter_drain(yaml_emitter_t *emitter)
 {
-    switch (*tag++) {
-    case 't': /* tag URI */
-        if (strncmp(tag, "ag:", 3))
-            break;
-        tag += 3;
+    int dummies = 0;
 
-        switch (*tag++) {
-        case 'y': /* yaml.org,2002: */
-            if (strncmp(tag, "aml.org,2002:", 13))
-                break;
-            return _yaml_tag2type(tag + 13);
-        }
-        break;
+    while (emitter->events.tail - emitter->events.head > dummies) {
+        yaml_event_t event;
+
+        if (!yaml_mapping_start_event_initialize(&event, NULL, NULL, true,
+                                                 YAML_BLOCK_MAPPING_STYLE)
+         || !yaml_emitter_emit(emitter, &event))
+            return false;
+        dummies++;
     }
 
-    /* Local tag */
-    errno = ENOTSUP;
-    return -1;
+    while (dummies--)
+        yaml_event_delete(--emitter->events.tail);
+    return true;
 }
 
-bool
-yaml_parse_null(const yaml_event_t *event)
+/* Emit the first line of a literal block scalar, make sure libyaml writes it
+ * out, and return the indentation it used for it (or -1 on error)
+ */
+static int
+emit_first_line(yaml_emitter_t *emitter, const char *line, size_t length)
 {
-    const char *value = yaml_scalar_value(event);
-    const char *tag = yaml_scalar_tag(event);
-
-    assert(event->type == YAML_SCALAR_EVENT);
+    if (!yaml_emit_scalar(emitter, YAML_BINARY_TAG, line, length,
+                          YAML_LITERAL_SCALAR_STYLE)
+     || !emitter_drain(emitter) || !yaml_emitter_flush(emitter))
+        return -1;
 
-    if (tag) {
-        errno = EINVAL;
-        return yaml_tag2type(tag) == YT_NULL;
-    }
-    if (!yaml_scalar_is_plain(event))
-        goto out_einval;
+    /* The scalar is processed: libyaml is back to the indentation of the
+     * collection that holds it (-1 at the root), to which it added one level
+     * for the scalar's content.
+     */
+    return emitter->indent < 0 ? emitter->best_indent
+                               : emitter->indent + emitter->best_indent;
+}
 
-    switch (*value++) {
-    case '\0': /* (empty) */
-        return true;
-    case '~': /* ~ */
-        if (*value != '\0')
-            break;
-        return true;
-    case 'n': /* null */
-        if (strcmp(value, "ull"))
-            break;
+static bool
+emitter_write(yaml_emitter_t *emitter, const char *buffer, size_t size)
+{
+    if (emitter->write_handler(emitter->write_handler_data,
+                               (unsigned char *)buffer, size))
         return true;
-    case 'N': /* Null, NULL */
-        switch (*value++) {
-        case 'u': /* Null */
-            if (strcmp(value, "ll"))
-                break;
-            return true;
-        case 'U': /* NULL */
-            if (strcmp(value, "LL"))
-                break;
-            return true;
-        }
-        break;
-    }
 
-out_einval:
-    errno = EINVAL;
+    emitter->error = YAML_WRITER_ERROR;
+    emitter->problem = "write error";
     return false;
 }
 
+static const char *
+emitter_line_break(const yaml_emitter_t *emitter)
+{
+    switch (emitter->line_break) {
+    case YAML_CR_BREAK:
+        return "\r";
+    case YAML_CRLN_BREAK:
+        return "\r\n";
+    default:
+        return "\n";
+    }
+}
+
 bool
-yaml_parse_boolean(const yaml_event_t *event, bool *b)
+yaml_emit_binary_stream(yaml_emitter_t *emitter, const char *data, size_t size)
 {
-    const char *value = yaml_scalar_value(event);
-    const char *tag = yaml_scalar_tag(event);
+    const char *eol = emitter_line_break(emitter);
+    size_t eol_length = strlen(eol);
+    char output[4096];
+    size_t length = 0;
+    char line[BINARY_LINE_WIDTH + 2];
+    size_t first;
+    int indent;
 
-    assert(event->type == YAML_SCALAR_EVENT);
+    /* Everything that decides the style of the scalar is checked here, before
+     * anything is written: the lines of a base64 encoded scalar always allow
+     * for a literal block scalar, and as they are multiline, they are never
+     * emitted as simple keys. What remains is that block scalars are only
+     * available in block context and outside canonical mode.
+     *
+     * This function also bypasses libyaml's output buffer (and its conversion
+     * to UTF-16), and each indented line must fit in output[] (the events
+     * libyaml has yet to process may add up to 3 levels of indentation, and
+     * the scalar itself one more).
+     */
+    if (size == 0 || !libyaml_internals_checked()
+     || emitter->canonical || emitter->flow_level
+     || emitter->encoding != YAML_UTF8_ENCODING
+     || emitter->indent + 4 * emitter->best_indent
+            > (int)(sizeof(output) - BINARY_LINE_WIDTH - 3)
+     || emitter_queues_flow(emitter))
+        return yaml_emit_binary(emitter, data, size);
 
-    if (tag ? yaml_tag2type(tag) != YT_BOOL : !yaml_scalar_is_plain(event)) {
-        errno = EINVAL;
+    first = size < BINARY_LINE_BYTES ? size : BINARY_LINE_BYTES;
+    length = base64_encode(line, data, first);
+    line[length++] = '\n';
+    data += first;
+    size -= first;
+
+    indent = emit_first_line(emitter, line, length);
+    if (indent < 0)
         return false;
-    }
 
-    switch (*value++) {
-    case 'F': /* False, FALSE */
-        switch (*value++) {
-        case 'A': /* FALSE */
-            if (strcmp(value, "LSE"))
-                break;
-            *b = false;
-            return true;
-        case 'a': /* False */
-            if (strcmp(value, "lse"))
-                break;
-            *b = false;
-            return true;
-        }
-        break;
-    case 'f': /* false */
-        if (strcmp(value, "alse"))
-            break;
-        *b = false;
-        return true;
-    case 'N': /* N, No, NO */
-        switch (*value++) {
-        case '\0': /* N */
-            *b = false;
-            return true;
-        case 'O': /* NO */
-        case 'o': /* No */
-            if (*value != '\0')
-                break;
-            *b = false;
-            return true;
-        }
-        break;
-    case 'n': /* n, no */
-        switch (*value++) {
-        case '\0': /* n */
-            *b = false;
-            return true;
-        case 'o': /* no */
-            if (*value != '\0')
-                break;
-            *b = false;
-            return true;
-        }
-        break;
-    case 'O': /* On, ON, Off, OFF */
-        switch (*value++) {
-        case 'F': /* OFF */
-            if (strcmp(value, "F"))
-                break;
-            *b = false;
-            return true;
-        case 'f': /* Off */
-            if (strcmp(value, "f"))
-                break;
-            *b = false;
-            return true;
-        case 'N': /* ON */
-        case 'n': /* On */
-            if (*value != '\0')
-                break;
-            *b = true;
-            return true;
-        }
-        break;
-    case 'o': /* on, off */
-        switch (*value++) {
-        case 'f': /* off */
-            if (strcmp(value, "f"))
-                break;
-            *b = false;
-            return true;
-        case 'n': /* on */
-            if (*value != '\0')
-                break;
-            *b = true;
-            return true;
-        }
-        break;
-    case 'T': /* True, TRUE */
-        switch (*value++) {
-        case 'R': /* TRUE */
-            if (strcmp(value, "UE"))
-                break;
-            *b = true;
-            return true;
-        case 'r': /* True */
-            if (strcmp(value, "ue"))
-                break;
-            *b = true;
-            return true;
-        }
-        break;
-    case 't': /* true */
-        if (strcmp(value, "rue"))
-            break;
-        *b = true;
-        return true;
-    case 'Y': /* Y, Yes, YES */
-        switch (*value++) {
-        case '\0': /* Y */
-            *b = true;
-            return true;
-        case 'E': /* YES */
-            if (strcmp(value, "S"))
-                break;
-            *b = true;
-            return true;
-        case 'e': /* Yes */
-            if (strcmp(value, "s"))
-                break;
-            *b = true;
-            return true;
-        }
-        break;
-    case 'y': /* y, yes */
-        switch (*value++) {
-        case '\0':
-            *b = true;
-            return true;
-        case 'e': /* yes */
-            if (strcmp(value, "s"))
-                break;
-            *b = true;
-            return true;
+    /* libyaml is now waiting for the next event, the rest of the scalar is
+     * written straight to the output, one line at a time.
+     */
+    length = 0;
+    while (size) {
+        size_t n = size < BINARY_LINE_BYTES ? size : BINARY_LINE_BYTES;
+
+        if (sizeof(output) - length < indent + BINARY_LINE_WIDTH + eol_length
+                                      + 1) {
+            if (!emitter_write(emitter, output, length))
+                return false;
+            length = 0;
         }
-        break;
+
+        memset(output + length, ' ', indent);
+        length += indent;
+        length += base64_encode(output + length, data, n);
+        memcpy(output + length, eol, eol_length);
+        length += eol_length;
+
+        data += n;
+        size -= n;
     }
 
-    errno = EINVAL;
-    return false;
+    return length == 0 || emitter_write(emitter, output, length);
 }
 
-bool
-yaml_parse_integer(const yaml_event_t *event, intmax_t *i)
+static bool
+is_binary(const yaml_event_t *event)
 {
-    const char *value = yaml_scalar_value(event);
-    const char *tag = yaml_scalar_tag(event);
-    int save_errno;
-    char *end;
-
     assert(event->type == YAML_SCALAR_EVENT);
 
-    if (tag ? yaml_tag2type(tag) != YT_INT : !yaml_scalar_is_plain(event)) {
-        errno = EINVAL;
-        return false;
-    }
+    return is_of_type(yaml_scalar_style(event), yaml_scalar_tag(event),
+                      YT_BINARY);
+}
 
-    save_errno = errno;
-    errno = 0;
-    *i = strtoimax(value, &end, 0);
-    if ((*i == INTMAX_MIN || *i == INTMAX_MAX) && errno == ERANGE)
-        return false;
-    if (*end != '\0' || value == end) {
-        errno = EINVAL;
+static bool
+parse_binary(const char *value, size_t length, yaml_scalar_style_t style,
+             const char *tag, char *buffer, size_t *size,
+             ssize_t (*decode)(char *dest, const char *src, size_t n))
+{
+    ssize_t rc;
+
+    if (!is_of_type(style, tag, YT_BINARY))
         return false;
-    }
 
-    errno = save_errno;
-    return true;
+    rc = decode(buffer, value, length);
+    if (rc != -1)
+        *size = rc;
+    return rc != -1;
 }
 
 bool
-yaml_parse_unsigned_integer(const yaml_event_t *event, uintmax_t *u)
+yaml_parse_binary(const yaml_event_t *event, char *buffer, size_t *size)
 {
-    const char *value = yaml_scalar_value(event);
-    const char *tag = yaml_scalar_tag(event);
-    int save_errno;
-    char *end;
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    return parse_binary(yaml_scalar_value(event), yaml_scalar_length(event),
+                        yaml_scalar_style(event), yaml_scalar_tag(event),
+                        buffer, size, base64_decode);
+}
 
+bool
+yaml_parse_binary_strict(const yaml_event_t *event, char *buffer, size_t *size)
+{
     assert(event->type == YAML_SCALAR_EVENT);
 
-    if (tag ? yaml_tag2type(tag) != YT_INT : !yaml_scalar_is_plain(event)) {
-        errno = EINVAL;
-        return false;
-    }
+    return parse_binary(yaml_scalar_value(event), yaml_scalar_length(event),
+                        yaml_scalar_style(event), yaml_scalar_tag(event),
+                        buffer, size, base64_decode_strict);
+}
 
-    save_errno = errno;
-    errno = 0;
-    *u = strtoumax(value, &end, 0);
-    if ((*u == UINTMAX_MAX) && errno == ERANGE)
-        return false;
-    if (*end != '\0' || value == end) {
-        errno = EINVAL;
+bool
+yaml_parse_binary_size(const yaml_event_t *event, size_t *size)
+{
+    ssize_t rc;
+
+    if (!is_binary(event))
         return false;
-    }
 
-    errno = save_errno;
-    return true;
+    rc = base64_decoded_size(yaml_scalar_value(event),
+                             yaml_scalar_length(event));
+    if (rc != -1)
+        *size = rc;
+    return rc != -1;
 }
 
 bool
-yaml_parse_string(const yaml_event_t *event, const char **string,
-                  size_t *length)
+yaml_parse_binary_n(const char *value, size_t length,
+                    yaml_scalar_style_t style, const char *tag, char *buffer,
+                    size_t *size)
 {
-    const char *tag = yaml_scalar_tag(event);
+    return parse_binary(value, length, style, tag, buffer, size,
+                        base64_decode);
+}
 
+bool
+yaml_parse_binary_bounded(const yaml_event_t *event, char *buffer,
+                          size_t capacity, size_t *size)
+{
     assert(event->type == YAML_SCALAR_EVENT);
 
-    if (tag && yaml_tag2type(tag) != YT_STR) {
-        errno = EINVAL;
+    return yaml_parse_binary_bounded_n(yaml_scalar_value(event),
+                                       yaml_scalar_length(event),
+                                       yaml_scalar_style(event),
+                                       yaml_scalar_tag(event), buffer,
+                                       capacity, size);
+}
+
+bool
+yaml_parse_binary_bounded_n(const char *value, size_t length,
+                            yaml_scalar_style_t style, const char *tag,
+                            char *buffer, size_t capacity, size_t *size)
+{
+    ssize_t rc;
+
+    if (!is_of_type(style, tag, YT_BINARY))
         return false;
-    }
 
-    *string = yaml_scalar_value(event);
-    if (length)
-        *length = event->data.scalar.length;
-    return true;
+    rc = base64_decode_bounded(buffer, capacity, value, length);
+    if (rc != -1)
+        *size = rc;
+    return rc != -1;
 }
 
-#ifndef YAML_BINARY_TAG
-# define YAML_BINARY_TAG "tag:yaml.org,2002:binary"
-#endif
-
-static bool
-_yaml_emit_binary(yaml_emitter_t *emitter, const char *b64, size_t size)
+bool
+yaml_parse_binary_inplace(yaml_event_t *event, char **data, size_t *size)
 {
-    return yaml_emit_scalar(emitter, YAML_BINARY_TAG, b64, size,
-                            YAML_ANY_SCALAR_STYLE);
+    char *value = (char *)event->data.scalar.value;
+    ssize_t rc;
+
+    if (!is_binary(event))
+        return false;
+
+    /* Decoders never write past the characters they already read */
+    rc = base64_decode(value, value, yaml_scalar_length(event));
+    if (rc == -1)
+        return false;
+
+    *data = value;
+    *size = rc;
+    return true;
 }
 
 bool
-yaml_emit_binary(yaml_emitter_t *emitter, const char *data, size_t size)
+yaml_emit_hex(yaml_emitter_t *emitter, const char *tag, const char *data,
+              size_t size)
 {
     char onstack[256];
     char *buffer = onstack;
     bool success;
 
-    /* Encoding in base64 increases the size by a factor of 4/3
-     *                     vvvv      vvvvvvv
-     */
-    if (sizeof(onstack) < (size + 2) * 4 / 3 + 1) {
-        /*                      ^^^          ^^^
-         * Account for padding bytes   and   the terminating null byte
-         */
-        buffer = malloc((size + 2) * 4 / 3 + 1);
+    if (sizeof(onstack) < 2 * size + 1) {
+        buffer = malloc(2 * size + 1);
         if (buffer == NULL)
             return false;
     }
 
-    size = base64_encode(buffer, data, size);
-    success = _yaml_emit_binary(emitter, buffer, size);
+    size = hex_encode(buffer, data, size);
+    success = yaml_emit_scalar(emitter, tag ? tag : YAML_HEX_TAG, buffer, size,
+                               YAML_ANY_SCALAR_STYLE);
     if (buffer != onstack)
         free(buffer);
     return success;
 }
 
+/* Same rules as binary data, except the tag is the caller's */
+static bool
+is_hex(const yaml_event_t *event, const char *tag)
+{
+    const char *event_tag = yaml_scalar_tag(event);
+    enum yaml_type type;
+
+    assert(event->type == YAML_SCALAR_EVENT);
+
+    if (event_tag == NULL) {
+        if (yaml_scalar_is_plain(event))
+            return true;
+        goto out_einval;
+    }
+
+    if (tag == NULL)
+        tag = YAML_HEX_TAG;
+
+    if (strcmp(event_tag, tag) == 0)
+        return true;
+
+    /* The same type under another notation (eg. !!str) */
+    type = yaml_tag2type(event_tag);
+    if (type != YT_UNKNOWN && type == yaml_tag2type(tag))
+        return true;
+
+out_einval:
+    errno = EINVAL;
+    return false;
+}
+
 bool
-yaml_parse_binary(const yaml_event_t *event, char *buffer, size_t *size)
+yaml_parse_hex(const yaml_event_t *event, const char *tag, char *data,
+               size_t capacity, size_t *size)
 {
-    const char *value = yaml_scalar_value(event);
     size_t length = yaml_scalar_length(event);
-    const char *tag = yaml_scalar_tag(event);
     ssize_t rc;
 
-    assert(event->type == YAML_SCALAR_EVENT);
+    if (!is_hex(event, tag))
+        return false;
 
-    if (tag ? yaml_tag2type(tag) != YT_BINARY : !yaml_scalar_is_plain(event)) {
-        errno = EINVAL;
+    if (length / 2 > capacity) {
+        errno = ENOBUFS;
         return false;
     }
 
-    rc = base64_decode(buffer, value, length);
+    rc = hex_decode(data, yaml_scalar_value(event), length);
     if (rc != -1)
         *size = rc;
     return rc != -1;
 }
+
+#define DEFINE_HEX_ID(bytes) \
+bool \
+yaml_emit_hex_ ## bytes(yaml_emitter_t *emitter, const char *tag, \
+                        const char data[bytes]) \
+{ \
+    char buffer[2 * bytes + 1]; \
+ \
+    hex_encode_ ## bytes(buffer, data); \
+    return yaml_emit_scalar(emitter, tag ? tag : YAML_HEX_TAG, buffer, \
+                            2 * bytes, YAML_ANY_SCALAR_STYLE); \
+} \
+ \
+bool \
+yaml_parse_hex_ ## bytes(const yaml_event_t *event, const char *tag, \
+                         char data[bytes]) \
+{ \
+    if (!is_hex(event, tag)) \
+        return false; \
+ \
+    if (yaml_scalar_length(event) != 2 * bytes) { \
+        errno = EINVAL; \
+        return false; \
+    } \
+ \
+    return hex_decode_ ## bytes(data, yaml_scalar_value(event)) != -1; \
+}
+
+DEFINE_HEX_ID(16)
+DEFINE_HEX_ID(20)
+DEFINE_HEX_ID(32)
@@ -0,0 +1,263 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "miniyaml.h"
+
+/* Streams are never parsed by more threads than this */
+#define MAX_THREADS 64
+
+/* Documents are handed out to threads in batches of consecutive documents,
+ * each parsed with a parser of its own: batches are cut once they hold at
+ * least this many bytes, so that small documents do not each pay for the
+ * setup of a parser.
+ */
+#define BATCH_SIZE (64 << 10)
+
+struct batch {
+    /* The slice of the stream the batch spans */
+    size_t offset;
+    size_t length;
+    /* The index of its first document, and the number of documents in it */
+    size_t first;
+    size_t count;
+    /* The number of documents that were handed to parse() */
+    size_t parsed;
+    bool done;
+};
+
+struct pool {
+    const char *input;
+    yaml_parse_document_t *parse;
+    yaml_deliver_document_t *deliver;
+    void *data;
+
+    struct batch *batches;
+    size_t batch_count;
+    /* The next batch to parse */
+    size_t next;
+
+    /* In order delivery only: results wait here until every document that
+     * precedes them is delivered
+     */
+    void **results;
+    /* The first batch that is not delivered yet */
+    size_t delivered;
+
+    /* Deliveries never overlap */
+    pthread_mutex_t lock;
+    /* The first error encountered, if any */
+    int error;
+};
+
+static void
+fail(struct pool *pool, int error)
+{
+    int expected = 0;
+
+    __atomic_compare_exchange_n(&pool->error, &expected, error, false,
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+static void
+deliver_batch(struct pool *pool, const struct batch *batch)
+{
+    for (size_t i = batch->first; i < batch->first + batch->parsed; i++)
+        pool->deliver(pool->results[i], i, pool->data);
+}
+
+static void
+parse_batch(struct pool *pool, struct batch *batch)
+{
+    yaml_event_type_t type;
+    yaml_parser_t parser;
+    size_t index = batch->first;
+
+    if (!yaml_parser_initialize(&parser)) {
+        fail(pool, ENOMEM);
+        return;
+    }
+
+    yaml_parser_set_input_string(&parser,
+                                 (const unsigned char *)pool->input
+                                 + batch->offset, batch->length);
+    yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+
+    do {
+        yaml_event_t event;
+        void *result;
+
+        /* libyaml yields empty events after an error, which parse() may
+         * have run into
+         */
+        if (!yaml_parser_parse(&parser, &event)
+         || parser.error != YAML_NO_ERROR) {
+            fail(pool, EINVAL);
+            break;
+        }
+
+        type = event.type;
+        yaml_event_delete(&event);
+
+        if (type != YAML_DOCUMENT_START_EVENT)
+            continue;
+
+        /* The index and libyaml disagree on where documents are */
+        if (index == batch->first + batch->count) {
+            fail(pool, EINVAL);
+            break;
+        }
+
+        result = pool->parse(&parser, index, pool->data);
+        batch->parsed++;
+
+        if (pool->results) {
+            pool->results[index] = result;
+        } else {
+            pthread_mutex_lock(&pool->lock);
+            pool->deliver(result, index, pool->data);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        index++;
+    } while (type != YAML_STREAM_END_EVENT);
+
+    yaml_parser_delete(&parser);
+}
+
+static void *
+worker(void *data)
+{
+    struct pool *pool = data;
+
+    while (!__atomic_load_n(&pool->error, __ATOMIC_RELAXED)) {
+        size_t i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+
+        if (i >= pool->batch_count)
+            break;
+
+        parse_batch(pool, &pool->batches[i]);
+        if (pool->results == NULL)
+            continue;
+
+        /* Deliver every batch that is no longer waiting on another one */
+        pthread_mutex_lock(&pool->lock);
+        pool->batches[i].done = true;
+        while (pool->delivered < pool->batch_count
+            && pool->batches[pool->delivered].done)
+            deliver_batch(pool, &pool->batches[pool->delivered++]);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return NULL;
+}
+
+/* Group documents into batches, return the number of batches */
+static size_t
+make_batches(struct batch *batches,
+             const struct yaml_document_offset *documents, size_t count,
+             size_t length)
+{
+    size_t size = 0;
+
+    for (size_t i = 0; i < count; ) {
+        struct batch *batch = &batches[size++];
+        size_t end;
+
+        batch->offset = documents[i].offset;
+        batch->first = i;
+        do {
+            i++;
+            end = i < count ? documents[i].offset : length;
+        } while (i < count && end - batch->offset < BATCH_SIZE);
+
+        batch->length = end - batch->offset;
+        batch->count = i - batch->first;
+        batch->parsed = 0;
+        batch->done = false;
+    }
+
+    return size;
+}
+
+bool
+yaml_parallel_parse(const char *input, size_t length, unsigned int threads,
+                    bool ordered, yaml_parse_document_t *parse,
+                    yaml_deliver_document_t *deliver, void *data)
+{
+    struct yaml_document_offset *documents;
+    pthread_t workers[MAX_THREADS];
+    struct pool pool = {
+        .input = input,
+        .parse = parse,
+        .deliver = deliver,
+        .data = data,
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+    };
+    unsigned int started;
+    size_t count;
+
+    if (!yaml_index_documents(input, length, &documents, &count))
+        return false;
+
+    pool.batches = malloc(count * sizeof(*pool.batches));
+    if (count && pool.batches == NULL)
+        goto out_free_documents;
+
+    if (ordered) {
+        pool.results = malloc(count * sizeof(*pool.results));
+        if (count && pool.results == NULL)
+            goto out_free_batches;
+    }
+
+    pool.batch_count = make_batches(pool.batches, documents, count, length);
+    free(documents);
+
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        threads = cpus > 0 ? cpus : 1;
+    }
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > pool.batch_count)
+        threads = pool.batch_count;
+
+    /* The calling thread is a worker too */
+    for (started = 1; started < threads; started++) {
+        if (pthread_create(&workers[started], NULL, worker, &pool))
+            break;
+    }
+
+    worker(&pool);
+    for (unsigned int i = 1; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    /* After an error, deliver what was parsed anyway */
+    while (pool.results && pool.delivered < pool.batch_count)
+        deliver_batch(&pool, &pool.batches[pool.delivered++]);
+
+    free(pool.results);
+    free(pool.batches);
+
+    if (pool.error) {
+        errno = pool.error;
+        return false;
+    }
+    return true;
+
+out_free_batches:
+    free(pool.batches);
+out_free_documents:
+    free(documents);
+    return false;
+}
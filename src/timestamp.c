@@ -0,0 +1,383 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "timestamp.h"
+
+#define SECONDS_PER_DAY 86400
+
+/* Days since 1970-01-01 of a date in the proleptic Gregorian calendar
+ *
+ * Howard Hinnant, "chrono-Compatible Low-Level Date Algorithms"
+ */
+static int64_t
+days_from_civil(int64_t year, unsigned int month, unsigned int day)
+{
+    int64_t era;
+    unsigned int year_of_era;
+    unsigned int day_of_year;
+    unsigned int day_of_era;
+
+    year -= month <= 2;
+    era = (year >= 0 ? year : year - 399) / 400;
+    year_of_era = year - era * 400;
+    day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100
+               + day_of_year;
+
+    return era * 146097 + day_of_era - 719468;
+}
+
+/* Inverse of days_from_civil() */
+static void
+civil_from_days(int64_t days, int64_t *year, unsigned int *month,
+                unsigned int *day)
+{
+    unsigned int year_of_era;
+    unsigned int day_of_year;
+    unsigned int day_of_era;
+    unsigned int mp;
+    int64_t era;
+
+    days += 719468;
+    era = (days >= 0 ? days : days - 146096) / 146097;
+    day_of_era = days - era * 146097;
+    year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524
+                   - day_of_era / 146096) / 365;
+    day_of_year = day_of_era
+                - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    mp = (5 * day_of_year + 2) / 153;
+
+    *day = day_of_year - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = year_of_era + era * 400 + (*month <= 2);
+}
+
+static bool
+is_leap_year(int64_t year)
+{
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+static unsigned int
+days_in_month(int64_t year, unsigned int month)
+{
+    static const unsigned char DAYS[] = {
+        31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31,
+    };
+
+    return DAYS[month - 1] + (month == 2 && is_leap_year(year));
+}
+
+/*----------------------------------------------------------------------------*
+ |                                 formatting                                 |
+ *----------------------------------------------------------------------------*/
+
+/* Records usually hold several timestamps of the same day: the "YYYY-MM-DD"
+ * prefix of the last one is kept around.
+ */
+static __thread struct {
+    int64_t days;
+    char date[10];
+} last_date = {
+    .days = INT64_MIN,
+};
+
+static inline void
+write_2_digits(char *dest, unsigned int n)
+{
+    dest[0] = '0' + n / 10;
+    dest[1] = '0' + n % 10;
+}
+
+size_t
+timestamp_format(char dest[TIMESTAMP_FORMAT_SIZE], const struct timespec *ts)
+{
+    int64_t days;
+    int64_t seconds;
+    char *c = dest;
+
+    if (ts->tv_nsec < 0 || ts->tv_nsec >= 1000000000) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    days = ts->tv_sec / SECONDS_PER_DAY;
+    seconds = ts->tv_sec % SECONDS_PER_DAY;
+    if (seconds < 0) {
+        seconds += SECONDS_PER_DAY;
+        days--;
+    }
+
+    if (days != last_date.days) {
+        unsigned int month, day;
+        int64_t year;
+
+        civil_from_days(days, &year, &month, &day);
+        if (year < 0 || year > 9999) {
+            errno = ERANGE;
+            return 0;
+        }
+
+        write_2_digits(last_date.date, year / 100);
+        write_2_digits(last_date.date + 2, year % 100);
+        last_date.date[4] = '-';
+        write_2_digits(last_date.date + 5, month);
+        last_date.date[7] = '-';
+        write_2_digits(last_date.date + 8, day);
+        last_date.days = days;
+    }
+
+    memcpy(c, last_date.date, sizeof(last_date.date));
+    c += sizeof(last_date.date);
+    *c++ = 'T';
+    write_2_digits(c, seconds / 3600);
+    c += 2;
+    *c++ = ':';
+    write_2_digits(c, seconds / 60 % 60);
+    c += 2;
+    *c++ = ':';
+    write_2_digits(c, seconds % 60);
+    c += 2;
+
+    if (ts->tv_nsec) {
+        long nsec = ts->tv_nsec;
+
+        *c++ = '.';
+        for (int i = 8; i >= 0; i--) {
+            c[i] = '0' + nsec % 10;
+            nsec /= 10;
+        }
+        c += 9;
+    }
+
+    *c++ = 'Z';
+    *c = '\0';
+    return c - dest;
+}
+
+/*----------------------------------------------------------------------------*
+ |                                  parsing                                   |
+ *----------------------------------------------------------------------------*/
+
+struct datetime {
+    int64_t year;
+    unsigned int month;
+    unsigned int day;
+    unsigned int hour;
+    unsigned int minute;
+    unsigned int second;
+    long nsec;
+    /* In seconds, east of UTC */
+    int offset;
+};
+
+static inline bool
+is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool
+to_timespec(const struct datetime *datetime, struct timespec *ts)
+{
+    int64_t seconds;
+
+    if (datetime->month < 1 || datetime->month > 12
+     || datetime->day < 1
+     || datetime->day > days_in_month(datetime->year, datetime->month)
+     || datetime->hour > 23 || datetime->minute > 59
+     /* Leap seconds */
+     || datetime->second > 60) {
+        errno = EINVAL;
+        return false;
+    }
+
+    seconds = days_from_civil(datetime->year, datetime->month, datetime->day)
+            * SECONDS_PER_DAY
+            + datetime->hour * 3600 + datetime->minute * 60 + datetime->second
+            - datetime->offset;
+
+    if ((time_t)seconds != seconds) {
+        errno = ERANGE;
+        return false;
+    }
+
+    ts->tv_sec = seconds;
+    ts->tv_nsec = datetime->nsec;
+    return true;
+}
+
+/* Parse exactly \p n digits */
+static inline bool
+fixed_digits(const char *src, size_t n, unsigned int *value)
+{
+    *value = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!is_digit(src[i]))
+            return false;
+        *value = *value * 10 + (src[i] - '0');
+    }
+    return true;
+}
+
+/* YYYY-MM-DDTHH:MM:SSZ and YYYY-MM-DDTHH:MM:SS.fffffffffZ, which is what
+ * timestamp_format() produces
+ */
+static bool
+parse_canonical(const char *src, size_t n, struct datetime *datetime)
+{
+    unsigned int year, nsec = 0;
+
+    if (n != 20 && n != 30)
+        return false;
+
+    if (src[4] != '-' || src[7] != '-' || src[10] != 'T' || src[13] != ':'
+     || src[16] != ':' || src[n - 1] != 'Z' || (n == 30 && src[19] != '.'))
+        return false;
+
+    if (!fixed_digits(src, 4, &year)
+     || !fixed_digits(src + 5, 2, &datetime->month)
+     || !fixed_digits(src + 8, 2, &datetime->day)
+     || !fixed_digits(src + 11, 2, &datetime->hour)
+     || !fixed_digits(src + 14, 2, &datetime->minute)
+     || !fixed_digits(src + 17, 2, &datetime->second)
+     || (n == 30 && !fixed_digits(src + 20, 9, &nsec)))
+        return false;
+
+    datetime->year = year;
+    datetime->nsec = nsec;
+    datetime->offset = 0;
+    return true;
+}
+
+/* Parse 1 or 2 digits */
+static const char *
+short_digits(const char *src, const char *end, unsigned int *value)
+{
+    if (src == end || !is_digit(*src))
+        return NULL;
+    *value = *src++ - '0';
+
+    if (src < end && is_digit(*src))
+        *value = *value * 10 + (*src++ - '0');
+    return src;
+}
+
+/* The whole YAML 1.1 grammar:
+ *
+ *     [0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9]      # (ymd)
+ *   | [0-9][0-9][0-9][0-9]-[0-9][0-9]?-[0-9][0-9]?    # (year, month, day)
+ *     ([Tt]|[ \t]+)[0-9][0-9]?:[0-9][0-9]:[0-9][0-9]  # (hour, minute, second)
+ *     (\.[0-9]*)?                                     # (fraction)
+ *     (([ \t]*)Z|[-+][0-9][0-9]?(:[0-9][0-9])?)?      # (time zone)
+ *
+ * Whitespace is also accepted before numerical time zones, as in the examples
+ * of the specification ("2001-12-14 21:59:43.10 -5").
+ */
+static bool
+parse_general(const char *src, size_t n, struct datetime *datetime)
+{
+    const char *end = src + n;
+    const char *date = src;
+    unsigned int year;
+
+    *datetime = (struct datetime){};
+
+    if (n < 8 || !fixed_digits(src, 4, &year) || src[4] != '-')
+        return false;
+    datetime->year = year;
+    src += 5;
+
+    src = short_digits(src, end, &datetime->month);
+    if (src == NULL || src == end || *src++ != '-')
+        return false;
+    src = short_digits(src, end, &datetime->day);
+    if (src == NULL)
+        return false;
+
+    /* Date only */
+    if (src == end)
+        return src - date == 10;
+
+    if (*src == 'T' || *src == 't') {
+        src++;
+    } else if (*src == ' ' || *src == '\t') {
+        while (src < end && (*src == ' ' || *src == '\t'))
+            src++;
+    } else {
+        return false;
+    }
+
+    src = short_digits(src, end, &datetime->hour);
+    if (src == NULL || end - src < 6 || *src != ':'
+     || !fixed_digits(src + 1, 2, &datetime->minute) || src[3] != ':'
+     || !fixed_digits(src + 4, 2, &datetime->second))
+        return false;
+    src += 6;
+
+    if (src < end && *src == '.') {
+        long scale = 100000000;
+
+        src++;
+        for (; src < end && is_digit(*src); src++) {
+            /* Anything below the nanosecond is ignored */
+            datetime->nsec += (*src - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    while (src < end && (*src == ' ' || *src == '\t'))
+        src++;
+
+    if (src == end)
+        return true;
+
+    if (*src == 'Z')
+        return src + 1 == end;
+
+    if (*src == '-' || *src == '+') {
+        int sign = *src++ == '-' ? -1 : 1;
+        unsigned int hours, minutes = 0;
+
+        src = short_digits(src, end, &hours);
+        if (src == NULL)
+            return false;
+        if (src < end) {
+            if (end - src != 3 || *src != ':'
+             || !fixed_digits(src + 1, 2, &minutes))
+                return false;
+            src += 3;
+        }
+        if (hours > 23 || minutes > 59)
+            return false;
+
+        datetime->offset = sign * (int)(hours * 3600 + minutes * 60);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+timestamp_parse(const char *src, size_t n, struct timespec *ts)
+{
+    struct datetime datetime;
+
+    if (!parse_canonical(src, n, &datetime)
+     && !parse_general(src, n, &datetime)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return to_timespec(&datetime, ts);
+}
@@ -0,0 +1,36 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/* Large enough for any output of timestamp_format() (including a null byte) */
+#define TIMESTAMP_FORMAT_SIZE 32
+
+/* Write \p ts as "YYYY-MM-DDTHH:MM:SSZ", or "YYYY-MM-DDTHH:MM:SS.fffffffffZ" if
+ * it has a fractional part (always in UTC)
+ *
+ * Return the number of characters written (excluding the null byte), or 0 and
+ * set errno to EINVAL if ts->tv_nsec is not in [0, 999999999], or to ERANGE if
+ * the year does not fit in 4 digits.
+ */
+size_t
+timestamp_format(char dest[TIMESTAMP_FORMAT_SIZE], const struct timespec *ts);
+
+/* Parse the \p n characters at \p src as a YAML timestamp
+ *
+ * Return false and set errno to EINVAL if \p src is not a valid timestamp, or
+ * to ERANGE if it cannot be represented as a time_t.
+ */
+bool
+timestamp_parse(const char *src, size_t n, struct timespec *ts);
+
+#endif
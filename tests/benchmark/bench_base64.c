@@ -0,0 +1,222 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#include <errno.h>
+#include <error.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <miniyaml.h>
+
+#include "../../src/base64.h"
+
+/* Every measure is repeated for at least that long (in seconds) */
+#define MIN_DURATION 0.1
+
+/* Buffers add up to about 4.7 times the largest size: 300 MiB by default */
+#define DEFAULT_MAX_SIZE ((size_t)64 << 20)
+
+/* What base64_encode() and base64_decode() use (runtime dispatch + threads) */
+#define DEFAULT_IMPLEMENTATION "default"
+
+static const char *PADDINGS[] = { "none", "==", "=" };
+
+enum layout {
+    LAYOUT_UNWRAPPED,
+    LAYOUT_WRAPPED,
+};
+
+static const char *LAYOUTS[] = {
+    [LAYOUT_UNWRAPPED] = "unwrapped",
+    [LAYOUT_WRAPPED] = "76-col",
+};
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Deterministic pseudo-random bytes (xorshift) */
+static void
+fill_random(char *buffer, size_t size)
+{
+    uint64_t x = 88172645463325252ULL;
+
+    for (size_t i = 0; i < size; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        buffer[i] = x;
+    }
+}
+
+/* Copy \p src into \p dest, breaking lines every 76 characters */
+static size_t
+wrap(char *dest, const char *src, size_t n)
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i < n; i += 76) {
+        size_t width = n - i < 76 ? n - i : 76;
+
+        if (i)
+            dest[length++] = '\n';
+        memcpy(dest + length, src + i, width);
+        length += width;
+    }
+
+    return length;
+}
+
+static void
+report(const char *implementation, const char *operation, size_t size,
+       const char *padding, const char *layout, double seconds)
+{
+    printf("%-12s %-6s %10zu %-5s %-9s %8.3f GB/s\n", implementation,
+           operation, size, padding, layout, size / seconds / 1e9);
+}
+
+/* Return the average duration of an encoding, in seconds */
+static double
+time_encode(const struct base64_codec *codec, char *dest, const char *src,
+            size_t n)
+{
+    double start = now();
+    double elapsed;
+    size_t repeat = 0;
+
+    /* Batches double in size so that reading the clock costs next to nothing */
+    for (size_t batch = 1; ; batch *= 2) {
+        for (size_t i = 0; i < batch; i++) {
+            size_t length = codec ? codec->encode(dest, src, n)
+                                  : base64_encode(dest, src, n);
+
+            if (length != (n + 2) / 3 * 4)
+                error(EXIT_FAILURE, 0, "encoding %zu bytes failed", n);
+        }
+        repeat += batch;
+
+        elapsed = now() - start;
+        if (elapsed >= MIN_DURATION)
+            return elapsed / repeat;
+    }
+}
+
+/* Return the average duration of a decoding, in seconds */
+static double
+time_decode(const struct base64_codec *codec, char *dest, const char *src,
+            size_t n, size_t expected)
+{
+    double start = now();
+    double elapsed;
+    size_t repeat = 0;
+
+    for (size_t batch = 1; ; batch *= 2) {
+        for (size_t i = 0; i < batch; i++) {
+            ssize_t size = codec ? base64_decode_codec(codec, dest, src, n, 0)
+                                 : base64_decode(dest, src, n);
+
+            if (size < 0 || (size_t)size != expected)
+                error(EXIT_FAILURE, errno, "decoding %zu bytes failed",
+                      expected);
+        }
+        repeat += batch;
+
+        elapsed = now() - start;
+        if (elapsed >= MIN_DURATION)
+            return elapsed / repeat;
+    }
+}
+
+static void
+bench(const struct base64_codec *codec, char *input, size_t size,
+      char *encoded, char *wrapped, char *decoded)
+{
+    const char *name = codec ? codec->name : DEFAULT_IMPLEMENTATION;
+    const char *padding = PADDINGS[size % 3];
+    size_t length;
+    double seconds;
+
+    seconds = time_encode(codec, encoded, input, size);
+    report(name, "encode", size, padding, "-", seconds);
+
+    for (enum layout layout = 0; layout < sizeof(LAYOUTS) / sizeof(*LAYOUTS);
+         layout++) {
+        const char *src = encoded;
+
+        length = (size + 2) / 3 * 4;
+        if (layout == LAYOUT_WRAPPED) {
+            length = wrap(wrapped, encoded, length);
+            src = wrapped;
+        }
+
+        seconds = time_decode(codec, decoded, src, length, size);
+        if (memcmp(decoded, input, size))
+            error(EXIT_FAILURE, 0, "decoding %zu bytes is wrong", size);
+        report(name, "decode", size, padding, LAYOUTS[layout], seconds);
+    }
+}
+
+/* Usage: bench_base64 [MAX_SIZE]
+ *
+ * Sizes go from 16 bytes to MAX_SIZE (64 MiB by default) by a factor of 4,
+ * each of them with every possible padding.
+ */
+int
+main(int argc, char *argv[])
+{
+    size_t max_size = DEFAULT_MAX_SIZE;
+    char *input, *encoded, *wrapped, *decoded;
+
+    if (argc > 1) {
+        char *end;
+
+        errno = 0;
+        max_size = strtoull(argv[1], &end, 0);
+        if (errno || *end != '\0' || max_size < 16)
+            error(EXIT_FAILURE, 0, "invalid maximum size: '%s'", argv[1]);
+    }
+
+    input = malloc(max_size + 2);
+    encoded = malloc((max_size + 4) / 3 * 4 + 1);
+    wrapped = malloc((max_size + 4) / 3 * 4 / 76 * 77 + 77);
+    decoded = malloc(max_size + 2);
+    if (!input || !encoded || !wrapped || !decoded)
+        error(EXIT_FAILURE, errno, "malloc");
+
+    fill_random(input, max_size + 2);
+
+    printf("%-12s %-6s %10s %-5s %-9s %13s\n", "codec", "op", "bytes",
+           "pad", "layout", "throughput");
+
+    for (size_t size = 16; size <= max_size; size *= 4) {
+        for (size_t pad = 0; pad < 3; pad++) {
+            size_t n = size - size % 3 + pad;
+
+            for (size_t i = 0; i < BASE64_CODECS_COUNT; i++) {
+                if (BASE64_CODECS[i].supported())
+                    bench(&BASE64_CODECS[i], input, n, encoded, wrapped,
+                          decoded);
+            }
+            bench(NULL, input, n, encoded, wrapped, decoded);
+        }
+        fflush(stdout);
+    }
+
+    free(decoded);
+    free(wrapped);
+    free(encoded);
+    free(input);
+    return EXIT_SUCCESS;
+}
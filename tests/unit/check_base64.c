@@ -11,9 +11,12 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <check.h>
+#include <miniyaml.h>
 
 #include "../../src/base64.h"
 
@@ -169,6 +172,199 @@ START_TEST(be_every_char)
 }
 END_TEST
 
+/*----------------------------------------------------------------------------*
+ |                               base64 codecs                                |
+ *----------------------------------------------------------------------------*/
+
+/* Deterministic pseudo-random bytes (xorshift) */
+static void
+fill_random(char *buffer, size_t size)
+{
+    uint64_t x = 88172645463325252ULL;
+
+    for (size_t i = 0; i < size; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        buffer[i] = x;
+    }
+}
+
+START_TEST(bc_encode)
+{
+    const struct base64_codec *codec = &BASE64_CODECS[_i];
+    char input[1024];
+    char expected[(sizeof(input) + 2) / 3 * 4 + 1];
+    char encoded[sizeof(expected)];
+
+    if (!codec->supported())
+        return;
+
+    fill_random(input, sizeof(input));
+
+    for (size_t n = 0; n <= sizeof(input); n++) {
+        size_t length = base64_encode_scalar(expected, input, n);
+
+        ck_assert_uint_eq(codec->encode(encoded, input, n), length);
+        ck_assert_str_eq(encoded, expected);
+    }
+}
+END_TEST
+
+START_TEST(bc_encode_unaligned)
+{
+    const struct base64_codec *codec = &BASE64_CODECS[_i];
+    char input[256 + 64];
+    char expected[(sizeof(input) + 2) / 3 * 4 + 1];
+    char encoded[sizeof(expected) + 64];
+
+    if (!codec->supported())
+        return;
+
+    fill_random(input, sizeof(input));
+
+    for (size_t offset = 0; offset < 64; offset++) {
+        size_t length = base64_encode_scalar(expected, input + offset, 256);
+
+        ck_assert_uint_eq(codec->encode(encoded + offset, input + offset, 256),
+                          length);
+        ck_assert_str_eq(encoded + offset, expected);
+    }
+}
+END_TEST
+
+/* Encode random data, wrapping lines every \p width characters with \p eol
+ * (padding characters are never separated from one another)
+ */
+static size_t
+encode_wrapped(char *dest, const char *src, size_t n, size_t width,
+               const char *eol)
+{
+    char *encoded = malloc((n + 2) / 3 * 4 + 1);
+    size_t length = base64_encode_scalar(encoded, src, n);
+    size_t j = 0;
+
+    ck_assert_ptr_nonnull(encoded);
+
+    for (size_t i = 0; i < length; i++) {
+        if (i && width && i % width == 0 && encoded[i] != '=') {
+            strcpy(dest + j, eol);
+            j += strlen(eol);
+        }
+        dest[j++] = encoded[i];
+    }
+
+    free(encoded);
+    return j;
+}
+
+static const struct {
+    size_t width;
+    const char *eol;
+} WRAPPINGS[] = {
+    { .width = 0, .eol = "" },
+    { .width = 76, .eol = "\n" },
+    { .width = 76, .eol = "\r\n" },
+    { .width = 60, .eol = "\n    " },
+    { .width = 7, .eol = " " },
+    { .width = 1, .eol = "\t" },
+};
+
+START_TEST(bc_decode)
+{
+    const struct base64_codec *codec = &BASE64_CODECS[_i];
+    char input[1024];
+    char encoded[sizeof(input) * 8];
+    char decoded[sizeof(input)];
+
+    if (!codec->supported())
+        return;
+
+    fill_random(input, sizeof(input));
+
+    for (size_t w = 0; w < sizeof(WRAPPINGS) / sizeof(WRAPPINGS[0]); w++) {
+        for (size_t n = 0; n <= sizeof(input); n += 1 + n / 16) {
+            size_t length = encode_wrapped(encoded, input, n,
+                                           WRAPPINGS[w].width,
+                                           WRAPPINGS[w].eol);
+
+            ck_assert_int_eq(base64_decode_codec(codec, decoded, encoded,
+                                                 length, 0),
+                             n);
+            ck_assert_mem_eq(decoded, input, n);
+        }
+    }
+}
+END_TEST
+
+/* Compare every codec with the scalar one on (mostly) invalid input */
+START_TEST(bc_decode_mutations)
+{
+    const struct base64_codec *codec = &BASE64_CODECS[_i];
+    const char MUTATIONS[] = { '=', '.', ' ', '\n', '\0', '\x80', 'A' };
+    char input[300];
+    char encoded[sizeof(input) * 2];
+    char expected[sizeof(input)];
+    char decoded[sizeof(input)];
+    size_t length;
+
+    if (!codec->supported())
+        return;
+
+    fill_random(input, sizeof(input));
+    length = encode_wrapped(encoded, input, sizeof(input), 76, "\n");
+
+    for (size_t i = 0; i < length; i += 3) {
+        for (size_t m = 0; m < sizeof(MUTATIONS); m++) {
+            char save = encoded[i];
+            ssize_t rc;
+
+            encoded[i] = MUTATIONS[m];
+
+            rc = base64_decode_codec(&BASE64_CODECS[0], expected, encoded,
+                                     length, 0);
+            errno = 0;
+            ck_assert_int_eq(base64_decode_codec(codec, decoded, encoded,
+                                                 length, 0),
+                             rc);
+            if (rc < 0)
+                ck_assert_int_eq(errno, EILSEQ);
+            else
+                ck_assert_mem_eq(decoded, expected, rc);
+
+            encoded[i] = save;
+        }
+    }
+}
+END_TEST
+
+START_TEST(bc_count)
+{
+    const struct base64_codec *codec = &BASE64_CODECS[_i];
+    char input[300];
+    char encoded[sizeof(input) * 8];
+
+    if (!codec->supported())
+        return;
+
+    fill_random(input, sizeof(input));
+
+    for (size_t w = 0; w < sizeof(WRAPPINGS) / sizeof(WRAPPINGS[0]); w++) {
+        for (size_t n = 0; n <= sizeof(input); n++) {
+            size_t length = encode_wrapped(encoded, input, n,
+                                           WRAPPINGS[w].width,
+                                           WRAPPINGS[w].eol);
+            const char *end = encoded + length;
+            const char *src = encoded;
+
+            ck_assert_uint_eq(codec->count(&src, end), (n * 4 + 2) / 3);
+            /* Stops at the padding */
+            ck_assert(src == end || *src == '=');
+        }
+    }
+}
+END_TEST
+
 /*----------------------------------------------------------------------------*
  |                              base64_decode()                               |
  *----------------------------------------------------------------------------*/
@@ -370,6 +566,490 @@ START_TEST(bd_trailing_encoding_error)
 }
 END_TEST
 
+START_TEST(bd_extraneous_padding)
+{
+    char input[] = {'A', 'A', '=', '=', '=', '='};
+    char decoded;
+
+    ck_assert_int_eq(base64_decode(&decoded, input, sizeof(input)), 1);
+    ck_assert_int_eq(decoded, 0);
+}
+END_TEST
+
+START_TEST(bd_non_ascii_space)
+{
+    /* Not a space, even if the current locale says so */
+    char input[] = {'A', 'A', '\xa0', 'A', 'A'};
+    char decoded[3];
+
+    errno = 0;
+    ck_assert_int_eq(base64_decode(decoded, input, sizeof(input)), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                           base64_decode_strict()                           |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    const char *input;
+    ssize_t rc;
+} STRICT_INPUTS[] = {
+    { "", 0 },
+    { "AAAA", 3 },
+    { "AA==", 1 },
+    { "AAA=", 2 },
+    { "AA", 1 },
+    { "AAA", 2 },
+    { " AA = = ", -1 },
+    { " AA == \n", 1 },
+    { "AA=", -1 },
+    { "AAA==", -1 },
+    { "AA===", -1 },
+    { "AAAA=", -1 },
+    { "AAAA====", -1 },
+};
+
+START_TEST(bds_padding)
+{
+    const char *input = STRICT_INPUTS[_i].input;
+    char decoded[3];
+
+    for (size_t i = 0; i < BASE64_CODECS_COUNT; i++) {
+        const struct base64_codec *codec = &BASE64_CODECS[i];
+
+        if (!codec->supported())
+            continue;
+
+        errno = 0;
+        ck_assert_int_eq(base64_decode_codec(codec, decoded, input,
+                                             strlen(input), BASE64_STRICT),
+                         STRICT_INPUTS[_i].rc);
+        if (STRICT_INPUTS[_i].rc < 0)
+            ck_assert_int_eq(errno, EILSEQ);
+    }
+    ck_assert_int_eq(base64_decode_strict(decoded, input, strlen(input)),
+                     STRICT_INPUTS[_i].rc);
+}
+END_TEST
+
+/* Padding at the end of a long (SIMD-sized) input */
+START_TEST(bds_long_padding)
+{
+    char input[100];
+    char encoded[sizeof(input) * 2];
+    char decoded[sizeof(input)];
+    size_t length;
+
+    fill_random(input, sizeof(input));
+    length = base64_encode(encoded, input, sizeof(input));
+    ck_assert_int_eq(encoded[length - 1], '=');
+
+    ck_assert_int_eq(base64_decode_strict(decoded, encoded, length),
+                     sizeof(input));
+    ck_assert_mem_eq(decoded, input, sizeof(input));
+
+    encoded[length++] = '=';
+    errno = 0;
+    ck_assert_int_eq(base64_decode_strict(decoded, encoded, length), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+    ck_assert_int_eq(base64_decode(decoded, encoded, length), sizeof(input));
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                           base64_decoded_size()                            |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(bdsz_wrapped)
+{
+    char input[300];
+    char encoded[sizeof(input) * 8];
+
+    fill_random(input, sizeof(input));
+
+    for (size_t w = 0; w < sizeof(WRAPPINGS) / sizeof(WRAPPINGS[0]); w++) {
+        for (size_t n = 0; n <= sizeof(input); n++) {
+            size_t length = encode_wrapped(encoded, input, n,
+                                           WRAPPINGS[w].width,
+                                           WRAPPINGS[w].eol);
+
+            ck_assert_int_eq(base64_decoded_size(encoded, length), n);
+        }
+    }
+}
+END_TEST
+
+START_TEST(bdsz_unpadded)
+{
+    ck_assert_int_eq(base64_decoded_size("AA", 2), 1);
+    ck_assert_int_eq(base64_decoded_size("AAA", 3), 2);
+    ck_assert_int_eq(base64_decoded_size("AAAA \n", 6), 3);
+}
+END_TEST
+
+static const char *UNSIZABLE_INPUTS[] = {
+    ".",
+    "A",
+    "AAAAA===",
+    "AA==AA==",
+    "AAA=\x80",
+};
+
+START_TEST(bdsz_encoding_error)
+{
+    const char *input = UNSIZABLE_INPUTS[_i];
+
+    errno = 0;
+    ck_assert_int_eq(base64_decoded_size(input, strlen(input)), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                          base64_decode_bounded()                           |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(bdb_capacity)
+{
+    char input[300];
+    char encoded[sizeof(input) * 8];
+    char decoded[sizeof(input) + 16];
+
+    fill_random(input, sizeof(input));
+
+    for (size_t w = 0; w < sizeof(WRAPPINGS) / sizeof(WRAPPINGS[0]); w++) {
+        for (size_t n = 0; n <= sizeof(input); n += 1 + n / 8) {
+            size_t length = encode_wrapped(encoded, input, n,
+                                           WRAPPINGS[w].width,
+                                           WRAPPINGS[w].eol);
+
+            memset(decoded, '.', sizeof(decoded));
+            ck_assert_int_eq(base64_decode_bounded(decoded, n, encoded,
+                                                   length),
+                             n);
+            ck_assert_mem_eq(decoded, input, n);
+            ck_assert_int_eq(decoded[n], '.');
+
+            if (n == 0)
+                continue;
+
+            memset(decoded, '.', sizeof(decoded));
+            errno = 0;
+            ck_assert_int_eq(base64_decode_bounded(decoded, n - 1, encoded,
+                                                   length),
+                             -1);
+            ck_assert_int_eq(errno, ENOBUFS);
+            ck_assert_int_eq(decoded[n - 1], '.');
+        }
+    }
+}
+END_TEST
+
+START_TEST(bdb_encoding_error)
+{
+    char decoded[8];
+
+    errno = 0;
+    ck_assert_int_eq(base64_decode_bounded(decoded, sizeof(decoded), "AA.", 3),
+                     -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                              base64_decoder_t                              |
+ *----------------------------------------------------------------------------*/
+
+/* Decode \p src in chunks of \p chunk characters (0 means random sizes) */
+static ssize_t
+decode_chunks(char *dest, const char *src, size_t n, size_t chunk, bool strict)
+{
+    base64_decoder_t decoder;
+    uint64_t x = 2463534242;
+    char *data = dest;
+    ssize_t rc;
+
+    base64_decoder_init(&decoder, strict);
+
+    while (n) {
+        size_t size = chunk;
+
+        if (size == 0) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            size = x % 100;
+        }
+        if (size > n)
+            size = n;
+
+        rc = base64_decoder_update(&decoder, data, src, size);
+        if (rc < 0)
+            return rc;
+        ck_assert_int_le(rc, (size + 3) / 4 * 3);
+        data += rc;
+        src += size;
+        n -= size;
+    }
+
+    rc = base64_decoder_finish(&decoder, data);
+    if (rc < 0)
+        return rc;
+    ck_assert_int_le(rc, 2);
+    return data + rc - dest;
+}
+
+START_TEST(bdr_chunks)
+{
+    char input[1000];
+    char encoded[sizeof(input) * 3];
+    char decoded[sizeof(input)];
+
+    fill_random(input, sizeof(input));
+
+    for (size_t w = 0; w < sizeof(WRAPPINGS) / sizeof(WRAPPINGS[0]); w++) {
+        for (size_t n = sizeof(input) - 2; n <= sizeof(input); n++) {
+            size_t length = encode_wrapped(encoded, input, n,
+                                           WRAPPINGS[w].width,
+                                           WRAPPINGS[w].eol);
+
+            for (size_t chunk = 0; chunk < 70; chunk++) {
+                ck_assert_int_eq(decode_chunks(decoded, encoded, length, chunk,
+                                               _i),
+                                 n);
+                ck_assert_mem_eq(decoded, input, n);
+            }
+        }
+    }
+}
+END_TEST
+
+/* Whatever the chunks, the result is the same as base64_decode()'s */
+START_TEST(bdr_mutations)
+{
+    const char MUTATIONS[] = { '=', '.', ' ', '\n', '\0', 'A' };
+    char input[100];
+    char encoded[sizeof(input) * 2 + 2];
+    char expected[sizeof(input) + 2];
+    char decoded[sizeof(input) + 2];
+    size_t length;
+
+    fill_random(input, sizeof(input));
+    length = encode_wrapped(encoded, input, sizeof(input), 16, "\n");
+    /* Extraneous padding */
+    encoded[length++] = '=';
+
+    for (size_t i = 0; i < length; i++) {
+        for (size_t m = 0; m < sizeof(MUTATIONS); m++) {
+            char save = encoded[i];
+            ssize_t rc;
+
+            encoded[i] = MUTATIONS[m];
+            rc = _i ? base64_decode_strict(expected, encoded, length)
+                    : base64_decode(expected, encoded, length);
+
+            for (size_t chunk = 0; chunk < 6; chunk++) {
+                errno = 0;
+                ck_assert_int_eq(decode_chunks(decoded, encoded, length, chunk,
+                                               _i),
+                                 rc);
+                if (rc < 0)
+                    ck_assert_int_eq(errno, EILSEQ);
+                else
+                    ck_assert_mem_eq(decoded, expected, rc);
+            }
+
+            encoded[i] = save;
+        }
+    }
+}
+END_TEST
+
+START_TEST(bdr_split_padding)
+{
+    base64_decoder_t decoder;
+    char decoded[2];
+
+    base64_decoder_init(&decoder, true);
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, "A", 1), 0);
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, "A=", 2), 0);
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, "= \n", 3), 0);
+    ck_assert_int_eq(base64_decoder_finish(&decoder, decoded), 1);
+    ck_assert_int_eq(decoded[0], 0);
+
+    base64_decoder_init(&decoder, false);
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, "AA=", 3), 0);
+    errno = 0;
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, " =", 2), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+START_TEST(bdr_sticky_error)
+{
+    base64_decoder_t decoder;
+    char decoded[3];
+
+    base64_decoder_init(&decoder, false);
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, ".", 1), -1);
+
+    errno = 0;
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, "AAAA", 4), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+
+    errno = 0;
+    ck_assert_int_eq(base64_decoder_finish(&decoder, decoded), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+START_TEST(bdr_too_short)
+{
+    base64_decoder_t decoder;
+    char decoded[3];
+
+    base64_decoder_init(&decoder, false);
+    ck_assert_int_eq(base64_decoder_update(&decoder, decoded, "AAAAA", 5), 3);
+
+    errno = 0;
+    ck_assert_int_eq(base64_decoder_finish(&decoder, decoded), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                               base64 threads                               |
+ *----------------------------------------------------------------------------*/
+
+static const unsigned int THREADS[] = { 2, 3, 8 };
+
+START_TEST(bt_encode)
+{
+    const unsigned int threads = THREADS[_i];
+    char input[4096];
+    char expected[(sizeof(input) + 2) / 3 * 4 + 1];
+    char encoded[sizeof(expected)];
+
+    fill_random(input, sizeof(input));
+
+    for (size_t n = 0; n <= sizeof(input); n += 1 + n / 8) {
+        for (size_t i = 0; i < BASE64_CODECS_COUNT; i++) {
+            const struct base64_codec *codec = &BASE64_CODECS[i];
+            size_t length;
+
+            if (!codec->supported())
+                continue;
+
+            length = base64_encode_scalar(expected, input, n);
+            ck_assert_uint_eq(base64_encode_threads(codec, encoded, input, n,
+                                                    threads),
+                              length);
+            ck_assert_str_eq(encoded, expected);
+        }
+    }
+}
+END_TEST
+
+START_TEST(bt_decode)
+{
+    const unsigned int threads = THREADS[_i];
+    char input[4096];
+    char encoded[sizeof(input) * 3];
+    char decoded[sizeof(input)];
+
+    fill_random(input, sizeof(input));
+
+    for (size_t w = 0; w < sizeof(WRAPPINGS) / sizeof(WRAPPINGS[0]); w++) {
+        for (size_t n = 0; n <= sizeof(input); n += 1 + n / 8) {
+            size_t length = encode_wrapped(encoded, input, n,
+                                           WRAPPINGS[w].width,
+                                           WRAPPINGS[w].eol);
+
+            for (size_t i = 0; i < BASE64_CODECS_COUNT; i++) {
+                const struct base64_codec *codec = &BASE64_CODECS[i];
+
+                if (!codec->supported())
+                    continue;
+
+                ck_assert_int_eq(base64_decode_threads(codec, decoded, encoded,
+                                                       length, 0, threads),
+                                 n);
+                ck_assert_mem_eq(decoded, input, n);
+            }
+        }
+    }
+}
+END_TEST
+
+/* Errors (or padding) in any part are reported as base64_decode() does */
+START_TEST(bt_decode_mutations)
+{
+    const unsigned int threads = THREADS[_i];
+    const char MUTATIONS[] = { '=', '.', ' ', '\n', 'A' };
+    char input[600];
+    char encoded[sizeof(input) * 2 + 1];
+    char expected[sizeof(input) + 2];
+    char decoded[sizeof(input) + 2];
+    size_t length;
+
+    fill_random(input, sizeof(input));
+    length = encode_wrapped(encoded, input, sizeof(input) - 1, 76, "\n");
+
+    for (size_t i = 0; i < length; i += 5) {
+        for (size_t m = 0; m < sizeof(MUTATIONS); m++) {
+            char save = encoded[i];
+
+            encoded[i] = MUTATIONS[m];
+
+            for (int strict = 0; strict < 2; strict++) {
+                enum base64_flags flags = strict ? BASE64_STRICT : 0;
+                ssize_t rc;
+
+                rc = base64_decode_codec(&BASE64_CODECS[0], expected, encoded,
+                                         length, flags);
+                errno = 0;
+                ck_assert_int_eq(base64_decode_threads(&BASE64_CODECS[0],
+                                                       decoded, encoded,
+                                                       length, flags, threads),
+                                 rc);
+                if (rc < 0)
+                    ck_assert_int_eq(errno, EILSEQ);
+                else
+                    ck_assert_mem_eq(decoded, expected, rc);
+            }
+
+            encoded[i] = save;
+        }
+    }
+}
+END_TEST
+
+START_TEST(bt_decode_inplace)
+{
+    const unsigned int threads = THREADS[_i];
+    char input[4096];
+    char encoded[sizeof(input) * 2];
+
+    fill_random(input, sizeof(input));
+
+    for (size_t i = 0; i < BASE64_CODECS_COUNT; i++) {
+        const struct base64_codec *codec = &BASE64_CODECS[i];
+        size_t length;
+
+        if (!codec->supported())
+            continue;
+
+        length = encode_wrapped(encoded, input, sizeof(input), 76, "\n");
+        ck_assert_int_eq(base64_decode_threads(codec, encoded, encoded, length,
+                                               0, threads),
+                         sizeof(input));
+        ck_assert_mem_eq(encoded, input, sizeof(input));
+    }
+}
+END_TEST
+
 static Suite *
 unit_suite(void)
 {
@@ -388,6 +1068,15 @@ unit_suite(void)
 
     suite_add_tcase(suite, tests);
 
+    tests = tcase_create("base64 codecs");
+    tcase_add_loop_test(tests, bc_encode, 0, BASE64_CODECS_COUNT);
+    tcase_add_loop_test(tests, bc_encode_unaligned, 0, BASE64_CODECS_COUNT);
+    tcase_add_loop_test(tests, bc_decode, 0, BASE64_CODECS_COUNT);
+    tcase_add_loop_test(tests, bc_decode_mutations, 0, BASE64_CODECS_COUNT);
+    tcase_add_loop_test(tests, bc_count, 0, BASE64_CODECS_COUNT);
+
+    suite_add_tcase(suite, tests);
+
     tests = tcase_create("base64_decode");
     tcase_add_test(tests, bd_nothing);
     tcase_add_test(tests, bd_leading_spaces);
@@ -405,6 +1094,50 @@ unit_suite(void)
     tcase_add_test(tests, bd_c1_encoding_error);
     tcase_add_test(tests, bd_c2_encoding_error);
     tcase_add_test(tests, bd_trailing_encoding_error);
+    tcase_add_test(tests, bd_extraneous_padding);
+    tcase_add_test(tests, bd_non_ascii_space);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("base64_decode_strict");
+    tcase_add_loop_test(tests, bds_padding, 0,
+                        sizeof(STRICT_INPUTS) / sizeof(STRICT_INPUTS[0]));
+    tcase_add_test(tests, bds_long_padding);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("base64_decoded_size");
+    tcase_add_test(tests, bdsz_wrapped);
+    tcase_add_test(tests, bdsz_unpadded);
+    tcase_add_loop_test(tests, bdsz_encoding_error, 0,
+                        sizeof(UNSIZABLE_INPUTS) / sizeof(UNSIZABLE_INPUTS[0]));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("base64_decode_bounded");
+    tcase_add_test(tests, bdb_capacity);
+    tcase_add_test(tests, bdb_encoding_error);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("base64_decoder_t");
+    tcase_add_loop_test(tests, bdr_chunks, 0, 2);
+    tcase_add_loop_test(tests, bdr_mutations, 0, 2);
+    tcase_add_test(tests, bdr_split_padding);
+    tcase_add_test(tests, bdr_sticky_error);
+    tcase_add_test(tests, bdr_too_short);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("base64 threads");
+    tcase_add_loop_test(tests, bt_encode, 0,
+                        sizeof(THREADS) / sizeof(THREADS[0]));
+    tcase_add_loop_test(tests, bt_decode, 0,
+                        sizeof(THREADS) / sizeof(THREADS[0]));
+    tcase_add_loop_test(tests, bt_decode_mutations, 0,
+                        sizeof(THREADS) / sizeof(THREADS[0]));
+    tcase_add_loop_test(tests, bt_decode_inplace, 0,
+                        sizeof(THREADS) / sizeof(THREADS[0]));
 
     suite_add_tcase(suite, tests);
 
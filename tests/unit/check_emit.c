@@ -9,10 +9,18 @@
 # include "config.h"
 #endif
 
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+
 #include <check.h>
 
 #include <miniyaml.h>
 
+#ifndef ARRAY_SIZE
+# define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+#endif
+
 static yaml_emitter_t emitter;
 
 static void
@@ -458,6 +466,51 @@ START_TEST(yei_max)
 }
 END_TEST
 
+/* Every number of digits, with and without a sign */
+START_TEST(yei_digits)
+{
+    intmax_t power = 1;
+    char *expected_output;
+    unsigned char *output;
+    size_t written = 0;
+    int size;
+
+    for (int i = 0; i < _i; i++)
+        power *= 10;
+
+    size = asprintf(&expected_output,
+                    "---\n- %" PRIiMAX "\n- %" PRIiMAX "\n- %" PRIiMAX
+                    "\n- %" PRIiMAX "\n...\n",
+                    power, power - 1, -power, 1 - power);
+    ck_assert_int_gt(size, 0);
+
+    output = calloc(1, size + 1);
+    ck_assert_ptr_nonnull(output);
+
+    yaml_emitter_set_output_string(&emitter, output, size + 1, &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+
+    ck_assert(yaml_emit_integer(&emitter, power));
+    ck_assert(yaml_emit_integer(&emitter, power - 1));
+    ck_assert(yaml_emit_integer(&emitter, -power));
+    ck_assert(yaml_emit_integer(&emitter, 1 - power));
+
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, size);
+    ck_assert_str_eq((char *)output, expected_output);
+
+    free(output);
+    free(expected_output);
+}
+END_TEST
+
 /*----------------------------------------------------------------------------*
  |                        yaml_emit_unsigned_integer()                        |
  *----------------------------------------------------------------------------*/
@@ -517,6 +570,225 @@ START_TEST(yeui_max)
 }
 END_TEST
 
+START_TEST(yeui_digits)
+{
+    uintmax_t power = 1;
+    char *expected_output;
+    unsigned char *output;
+    size_t written = 0;
+    int size;
+
+    for (int i = 0; i < _i; i++)
+        power *= 10;
+
+    size = asprintf(&expected_output,
+                    "---\n- %" PRIuMAX "\n- %" PRIuMAX "\n...\n",
+                    power, power - 1);
+    ck_assert_int_gt(size, 0);
+
+    output = calloc(1, size + 1);
+    ck_assert_ptr_nonnull(output);
+
+    yaml_emitter_set_output_string(&emitter, output, size + 1, &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+
+    ck_assert(yaml_emit_unsigned_integer(&emitter, power));
+    ck_assert(yaml_emit_unsigned_integer(&emitter, power - 1));
+
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, size);
+    ck_assert_str_eq((char *)output, expected_output);
+
+    free(output);
+    free(expected_output);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                              yaml_emit_float()                             |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    double d;
+    const char *output;
+} FLOATS[] = {
+    { 0., "0.0" },
+    { -0., "-0.0" },
+    { 1., "1.0" },
+    { -16., "-16.0" },
+    { 0.1, "0.1" },
+    { 0.3, "0.3" },
+    { 123.456, "123.456" },
+    { 0.00012, "0.00012" },
+    { 1e-5, "0.00001" },
+    { 1e-6, "1.0e-6" },
+    { 1e16, "10000000000000000.0" },
+    { 1e17, "1.0e+17" },
+    { 1.5e300, "1.5e+300" },
+    { 9007199254740993., "9007199254740992.0" },
+    { DBL_MAX, "1.7976931348623157e+308" },
+    { DBL_MIN, "2.2250738585072014e-308" },
+    { 5e-324, "5.0e-324" },
+    { INFINITY, ".inf" },
+    { -INFINITY, "-.inf" },
+    { NAN, ".nan" },
+};
+
+START_TEST(yef_values)
+{
+    char *expected_output;
+    unsigned char *output;
+    size_t written = 0;
+    int size;
+
+    size = asprintf(&expected_output, "--- %s\n...\n", FLOATS[_i].output);
+    ck_assert_int_gt(size, 0);
+
+    output = calloc(1, size + 1);
+    ck_assert_ptr_nonnull(output);
+
+    yaml_emitter_set_output_string(&emitter, output, size + 1, &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+
+    ck_assert(yaml_emit_float(&emitter, FLOATS[_i].d));
+
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, size);
+    ck_assert_str_eq((char *)output, expected_output);
+
+    free(output);
+    free(expected_output);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                           yaml_emit_timestamp()                            |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    struct timespec ts;
+    const char *output;
+} TIMESTAMPS[] = {
+    { { 0, 0 }, "1970-01-01T00:00:00Z" },
+    { { 1, 500000000 }, "1970-01-01T00:00:01.500000000Z" },
+    { { -1, 999999999 }, "1969-12-31T23:59:59.999999999Z" },
+    { { 951827405, 0 }, "2000-02-29T12:30:05Z" },
+    { { 1008367183, 100000000 }, "2001-12-14T21:59:43.100000000Z" },
+    { { -2203891200, 0 }, "1900-03-01T00:00:00Z" },
+    { { -62167219200, 0 }, "0000-01-01T00:00:00Z" },
+    { { 253402300799, 1 }, "9999-12-31T23:59:59.000000001Z" },
+};
+
+START_TEST(yets_values)
+{
+    char *expected_output;
+    unsigned char *output;
+    size_t written = 0;
+    int size;
+
+    size = asprintf(&expected_output, "--- %s\n...\n", TIMESTAMPS[_i].output);
+    ck_assert_int_gt(size, 0);
+
+    output = calloc(1, size + 1);
+    ck_assert_ptr_nonnull(output);
+
+    yaml_emitter_set_output_string(&emitter, output, size + 1, &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+
+    ck_assert(yaml_emit_timestamp(&emitter, TIMESTAMPS[_i].ts));
+
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, size);
+    ck_assert_str_eq((char *)output, expected_output);
+
+    free(output);
+    free(expected_output);
+}
+END_TEST
+
+/* The date of the previous timestamp is reused, make sure it is not reused
+ * when it should not be
+ */
+START_TEST(yets_same_day)
+{
+    const char EXPECTED_OUTPUT[] = "---\n"
+                                   "- 2001-12-14T00:00:00Z\n"
+                                   "- 2001-12-14T23:59:59Z\n"
+                                   "- 2001-12-15T00:00:00Z\n"
+                                   "- 2001-12-14T21:59:43.100000000Z\n"
+                                   "- 2001-12-14T21:59:43.100000000Z\n"
+                                   "...\n";
+    const struct timespec TIMESTAMPS[] = {
+        { 1008288000, 0 },
+        { 1008374399, 0 },
+        { 1008374400, 0 },
+        { 1008367183, 100000000 },
+        { 1008367183, 100000000 },
+    };
+    unsigned char output[sizeof(EXPECTED_OUTPUT)] = {};
+    size_t written = 0;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+
+    for (size_t i = 0; i < ARRAY_SIZE(TIMESTAMPS); i++)
+        ck_assert(yaml_emit_timestamp(&emitter, TIMESTAMPS[i]));
+
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, sizeof(EXPECTED_OUTPUT) - 1);
+    ck_assert_str_eq((char *)output, EXPECTED_OUTPUT);
+}
+END_TEST
+
+START_TEST(yets_invalid)
+{
+    const struct timespec EINVALS[] = {
+        { 0, -1 },
+        { 0, 1000000000 },
+    };
+    const struct timespec ERANGES[] = {
+        { -62167219201, 0 },
+        { 253402300800, 0 },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(EINVALS); i++) {
+        errno = 0;
+        ck_assert(!yaml_emit_timestamp(&emitter, EINVALS[i]));
+        ck_assert_int_eq(errno, EINVAL);
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(ERANGES); i++) {
+        errno = 0;
+        ck_assert(!yaml_emit_timestamp(&emitter, ERANGES[i]));
+        ck_assert_int_eq(errno, ERANGE);
+    }
+}
+END_TEST
+
 /*----------------------------------------------------------------------------*
  |                             yaml_emit_string()                             |
  *----------------------------------------------------------------------------*/
@@ -684,6 +956,586 @@ START_TEST(yebi_loooong)
 }
 END_TEST
 
+/*----------------------------------------------------------------------------*
+ |                         yaml_emit_binary_scratch()                         |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(yebisc_basic)
+{
+    const char EXPECTED_OUTPUT[] = "--- !!binary YWJjZGVm\n"
+                                   "...\n"
+                                   "--- !!binary YWJj\n"
+                                   "...\n";
+    unsigned char output[sizeof(EXPECTED_OUTPUT)] = {};
+    yaml_scratch_t scratch = {};
+    size_t written = 0;
+    char *data;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_binary_scratch(&emitter, "abcdef", 6, &scratch));
+    ck_assert(yaml_emit_document_end(&emitter));
+
+    ck_assert_ptr_nonnull(scratch.data);
+    ck_assert_uint_ge(scratch.size, 9);
+    data = scratch.data;
+
+    /* Smaller data does not need a bigger buffer */
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_binary_scratch(&emitter, "abc", 3, &scratch));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert_ptr_eq(scratch.data, data);
+
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, sizeof(output) - 1);
+    ck_assert_str_eq((char *)output, EXPECTED_OUTPUT);
+
+    yaml_scratch_delete(&scratch);
+    ck_assert_ptr_null(scratch.data);
+    ck_assert_uint_eq(scratch.size, 0);
+}
+END_TEST
+
+START_TEST(yebisc_grow)
+{
+    const char ZEROS[4096] = {};
+    yaml_scratch_t scratch = {};
+    unsigned char *output;
+    size_t capacity = 3 * 8 * sizeof(ZEROS);
+    size_t written = 0;
+
+    output = malloc(capacity);
+    ck_assert_ptr_nonnull(output);
+    yaml_emitter_set_output_string(&emitter, output, capacity, &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+
+    for (size_t size = 1; size <= sizeof(ZEROS); size *= 2) {
+        ck_assert(yaml_emit_binary_scratch(&emitter, ZEROS, size, &scratch));
+        ck_assert_uint_ge(scratch.size, (size + 2) / 3 * 4 + 1);
+    }
+
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    yaml_scratch_delete(&scratch);
+    free(output);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                          yaml_emit_binary_stream()                         |
+ *----------------------------------------------------------------------------*/
+
+/* yaml_emit_binary_stream() only streams with the libyaml release it was
+ * checked against, it falls back to yaml_emit_binary() with any other
+ */
+static bool
+streams_binary(void)
+{
+    int major, minor, patch;
+
+    yaml_get_version(&major, &minor, &patch);
+    return major == 0 && minor == 2 && patch == 5;
+}
+
+START_TEST(yebis_basic)
+{
+    const char EXPECTED_OUTPUT[] = "--- !!binary |\n"
+                                   "  YWJjZGVm\n"
+                                   "...\n";
+    unsigned char output[sizeof(EXPECTED_OUTPUT)] = {};
+    size_t written = 0;
+
+    if (!streams_binary())
+        return;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+
+    ck_assert(yaml_emit_binary_stream(&emitter, "abcdef", 6));
+
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, sizeof(output) - 1);
+    ck_assert_str_eq((char *)output, EXPECTED_OUTPUT);
+}
+END_TEST
+
+START_TEST(yebis_lines)
+{
+    const char EXPECTED_OUTPUT[] =
+        "---\r\n"
+        "key:\r\n"
+        "- !!binary |\r\n"
+        "  AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\r\n"
+        "  AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\r\n"
+        "  AAAA\r\n"
+        "...\r\n";
+    const char ZEROS[57 * 2 + 3] = {};
+    unsigned char output[sizeof(EXPECTED_OUTPUT)] = {};
+    size_t written = 0;
+
+    if (!streams_binary())
+        return;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+    yaml_emitter_set_break(&emitter, YAML_CRLN_BREAK);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_mapping_start(&emitter, NULL));
+    ck_assert(yaml_emit_scalar(&emitter, NULL, "key", 3,
+                               YAML_PLAIN_SCALAR_STYLE));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+
+    ck_assert(yaml_emit_binary_stream(&emitter, ZEROS, sizeof(ZEROS)));
+
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_mapping_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, sizeof(output) - 1);
+    ck_assert_str_eq((char *)output, EXPECTED_OUTPUT);
+}
+END_TEST
+
+/* Where to emit binary data in a document */
+enum layout {
+    LAYOUT_ROOT,
+    LAYOUT_KEY,
+    LAYOUT_VALUE,
+    LAYOUT_ITEM,
+    LAYOUT_NESTED,
+    LAYOUT_DEEP,
+    LAYOUT_MIXED,
+    LAYOUT_FLOW,
+    LAYOUT_COUNT,
+};
+
+typedef bool emit_binary_t(yaml_emitter_t *emitter, const char *data,
+                           size_t size);
+
+static bool
+emit_layout_with(enum layout layout, emit_binary_t *yaml_emit_binary_stream,
+                 const char *data, size_t size)
+{
+    yaml_event_t event;
+
+    switch (layout) {
+    case LAYOUT_ROOT:
+        return yaml_emit_binary_stream(&emitter, data, size);
+    case LAYOUT_KEY:
+        return yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_null(&emitter)
+            && yaml_emit_mapping_end(&emitter);
+    case LAYOUT_VALUE:
+        return yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_string(&emitter, "key", 3)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_string(&emitter, "other", 5)
+            && yaml_emit_null(&emitter)
+            && yaml_emit_mapping_end(&emitter);
+    case LAYOUT_ITEM:
+        return yaml_emit_sequence_start(&emitter, NULL)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_null(&emitter)
+            && yaml_emit_sequence_end(&emitter);
+    case LAYOUT_NESTED:
+        return yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_string(&emitter, "key", 3)
+            && yaml_emit_sequence_start(&emitter, NULL)
+            && yaml_emit_sequence_start(&emitter, NULL)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_sequence_end(&emitter)
+            && yaml_emit_sequence_end(&emitter)
+            && yaml_emit_mapping_end(&emitter);
+    case LAYOUT_DEEP:
+        return yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_string(&emitter, "key", 3)
+            && yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_string(&emitter, "key", 3)
+            && yaml_emit_sequence_start(&emitter, NULL)
+            && yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_string(&emitter, "value", 5)
+            && yaml_emit_string(&emitter, "key", 3)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_mapping_end(&emitter)
+            && yaml_emit_sequence_end(&emitter)
+            && yaml_emit_mapping_end(&emitter)
+            && yaml_emit_mapping_end(&emitter);
+    case LAYOUT_MIXED:
+        /* Streamed and regular scalars, with no flush in between */
+        return yaml_emit_sequence_start(&emitter, NULL)
+            && yaml_emit_string(&emitter, "a", 1)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_mapping_start(&emitter, NULL)
+            && yaml_emit_string(&emitter, "key", 3)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_string(&emitter, "other", 5)
+            && yaml_emit_string(&emitter, "b", 1)
+            && yaml_emit_mapping_end(&emitter)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_string(&emitter, "c", 1)
+            && yaml_emit_sequence_end(&emitter);
+    case LAYOUT_FLOW:
+        return yaml_sequence_start_event_initialize(&event, NULL, NULL, true,
+                                                    YAML_FLOW_SEQUENCE_STYLE)
+            && yaml_emitter_emit(&emitter, &event)
+            && yaml_emit_binary_stream(&emitter, data, size)
+            && yaml_emit_sequence_end(&emitter);
+    default:
+        return false;
+    }
+}
+
+static bool
+emit_layout(enum layout layout, const char *data, size_t size)
+{
+    return emit_layout_with(layout, yaml_emit_binary_stream, data, size);
+}
+
+static const size_t BINARY_SIZES[] = { 0, 1, 56, 57, 58, 57 * 100, 100000 };
+
+START_TEST(yebis_layouts)
+{
+    enum layout layout = _i % LAYOUT_COUNT;
+    size_t size = BINARY_SIZES[_i / LAYOUT_COUNT];
+    /* Room for the data to be emitted three times, base64 encoded and
+     * indented
+     */
+    size_t capacity = size * 5 + 1024;
+    unsigned char *output = malloc(capacity);
+    char *data = malloc(size + 1);
+    char *decoded = malloc(size + 1);
+    yaml_parser_t parser;
+    size_t written = 0;
+    yaml_event_t event;
+    size_t length;
+
+    ck_assert_ptr_nonnull(output);
+    ck_assert_ptr_nonnull(data);
+    ck_assert_ptr_nonnull(decoded);
+    for (size_t i = 0; i < size; i++)
+        data[i] = i * 7 + i / 251;
+
+    yaml_emitter_set_output_string(&emitter, output, capacity, &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(emit_layout(layout, data, size));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    /* Look for the (only) binary scalar */
+    ck_assert(yaml_parser_initialize(&parser));
+    yaml_parser_set_input_string(&parser, output, written);
+    do {
+        ck_assert(yaml_parser_parse(&parser, &event));
+        ck_assert_int_ne(event.type, YAML_STREAM_END_EVENT);
+        if (event.type == YAML_SCALAR_EVENT && yaml_scalar_tag(&event))
+            break;
+        yaml_event_delete(&event);
+    } while (true);
+
+    ck_assert(yaml_parse_binary(&event, decoded, &length));
+    ck_assert_uint_eq(length, size);
+    ck_assert_mem_eq(decoded, data, size);
+
+    yaml_event_delete(&event);
+    yaml_parser_delete(&parser);
+    free(decoded);
+    free(data);
+    free(output);
+}
+END_TEST
+
+/* Lines too indented for yaml_emit_binary_stream() to stream them */
+START_TEST(yebis_deep)
+{
+    const char ZEROS[57 * 3] = {};
+    unsigned char output[65536];
+    yaml_parser_t parser;
+    size_t written = 0;
+    yaml_event_t event;
+    char decoded[sizeof(ZEROS)];
+    size_t length;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+    yaml_emitter_set_indent(&emitter, 9);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    for (int i = 0; i < 500; i++)
+        ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+    ck_assert(yaml_emit_binary_stream(&emitter, ZEROS, sizeof(ZEROS)));
+    for (int i = 0; i < 500; i++)
+        ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert(yaml_parser_initialize(&parser));
+    yaml_parser_set_input_string(&parser, output, written);
+    do {
+        ck_assert(yaml_parser_parse(&parser, &event));
+        ck_assert_int_ne(event.type, YAML_STREAM_END_EVENT);
+        if (event.type == YAML_SCALAR_EVENT)
+            break;
+        yaml_event_delete(&event);
+    } while (true);
+
+    ck_assert(yaml_parse_binary(&event, decoded, &length));
+    ck_assert_uint_eq(length, sizeof(ZEROS));
+    ck_assert_mem_eq(decoded, ZEROS, length);
+
+    yaml_event_delete(&event);
+    yaml_parser_delete(&parser);
+}
+END_TEST
+
+/* What libyaml itself emits for bytes that are all zeros, as a literal block
+ * scalar with one line per 57 bytes
+ */
+static bool
+emit_zeros_literal(yaml_emitter_t *emitter, const char *data, size_t size)
+{
+    char *value = malloc((size + 56) / 57 * 77);
+    size_t length = 0;
+    bool success;
+
+    ck_assert_ptr_nonnull(value);
+    for (size_t i = 0; i < size; i += 57) {
+        size_t n = size - i < 57 ? size - i : 57;
+
+        memset(value + length, 'A', (n + 2) / 3 * 4);
+        length += (n + 2) / 3 * 4;
+        if (n % 3)
+            memset(value + length - 3 + n % 3, '=', 3 - n % 3);
+        value[length++] = '\n';
+    }
+
+    success = yaml_emit_scalar(emitter, "tag:yaml.org,2002:binary", value,
+                               length, YAML_LITERAL_SCALAR_STYLE);
+    free(value);
+    return success;
+}
+
+/* Emit a document laid out as @layout with a fresh emitter, into @output */
+static void
+emit_zeros_document(enum layout layout, emit_binary_t *emit_binary, int indent,
+                    unsigned char *output, size_t size)
+{
+    const char ZEROS[57 * 3 + 1] = {};
+    size_t written = 0;
+
+    emitter_exit();
+    emitter_init();
+    yaml_emitter_set_output_string(&emitter, output, size - 1, &written);
+    yaml_emitter_set_indent(&emitter, indent);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(emit_layout_with(layout, emit_binary, ZEROS, sizeof(ZEROS)));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+    output[written] = '\0';
+}
+
+static const int INDENTS[] = { 2, 4, 7 };
+
+/* Streamed scalars are indented exactly as libyaml's own */
+START_TEST(yebis_indent)
+{
+    enum layout layout = _i % LAYOUT_FLOW;
+    int indent = INDENTS[_i / LAYOUT_FLOW];
+    unsigned char expected[4096];
+    unsigned char output[4096];
+
+    if (!streams_binary())
+        return;
+
+    emit_zeros_document(layout, emit_zeros_literal, indent, expected,
+                        sizeof(expected));
+    emit_zeros_document(layout, yaml_emit_binary_stream, indent, output,
+                        sizeof(output));
+
+    ck_assert_str_eq((char *)output, (char *)expected);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                              yaml_emit_hex()                               |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(yeh_default_tag)
+{
+    const char EXPECTED_OUTPUT[] = "--- !hex 00017f80abff\n"
+                                   "...\n";
+    unsigned char output[sizeof(EXPECTED_OUTPUT)] = {};
+    size_t written = 0;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+
+    ck_assert(yaml_emit_hex(&emitter, NULL, "\x00\x01\x7f\x80\xab\xff", 6));
+
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, sizeof(output) - 1);
+    ck_assert_str_eq((char *)output, EXPECTED_OUTPUT);
+}
+END_TEST
+
+START_TEST(yeh_tagged)
+{
+    const char EXPECTED_OUTPUT[] = "--- !sha1 2fd4e1c67a2d28fced849ee1bb76e7391b93eb12\n"
+                                   "...\n";
+    const char SHA1[20] = "\x2f\xd4\xe1\xc6\x7a\x2d\x28\xfc\xed\x84"
+                          "\x9e\xe1\xbb\x76\xe7\x39\x1b\x93\xeb\x12";
+    unsigned char output[sizeof(EXPECTED_OUTPUT)] = {};
+    size_t written = 0;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+
+    ck_assert(yaml_emit_hex_20(&emitter, "!sha1", SHA1));
+
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_uint_eq(written, sizeof(output) - 1);
+    ck_assert_str_eq((char *)output, EXPECTED_OUTPUT);
+}
+END_TEST
+
+/* Identifiers that would read as numbers without a tag */
+static const struct {
+    const char *data;
+    size_t size;
+} DIGIT_IDS[] = {
+    { "\x00\x12", 2 },    /* 0012 */
+    { "\x10\xe5", 2 },    /* 10e5 */
+    { "\x12\x34\x56\x78", 4 },
+};
+
+START_TEST(yeh_digits)
+{
+    const char *ID = DIGIT_IDS[_i].data;
+    unsigned char output[64] = {};
+    struct yaml_scalar scalar;
+    yaml_parser_t parser;
+    yaml_event_t event;
+    size_t written = 0;
+    char data[4];
+    intmax_t i;
+    double d;
+    size_t size;
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_hex(&emitter, NULL, ID, DIGIT_IDS[_i].size));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert(yaml_parser_initialize(&parser));
+    yaml_parser_set_input_string(&parser, output, written);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(!yaml_parse_integer(&event, &i));
+    ck_assert(!yaml_parse_float(&event, &d));
+    errno = 0;
+    ck_assert(!yaml_parse_scalar_auto(&event, YAML_SCHEMA_1_1, &scalar));
+    ck_assert_int_eq(errno, ENOTSUP);
+    errno = 0;
+    ck_assert(!yaml_parse_scalar_auto(&event, YAML_SCHEMA_CORE, &scalar));
+    ck_assert_int_eq(errno, ENOTSUP);
+
+    ck_assert(yaml_parse_hex(&event, NULL, data, sizeof(data), &size));
+    ck_assert_uint_eq(size, DIGIT_IDS[_i].size);
+    ck_assert_mem_eq(data, ID, size);
+
+    yaml_event_delete(&event);
+    yaml_parser_delete(&parser);
+}
+END_TEST
+
+/* Larger than the buffer on the stack */
+START_TEST(yeh_loooong)
+{
+    unsigned char output[4096] = {};
+    char *expected_output;
+    char data[1024];
+    char *digits;
+    size_t written = 0;
+
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = i;
+
+    digits = malloc(2 * sizeof(data) + 1);
+    ck_assert_ptr_nonnull(digits);
+    for (size_t i = 0; i < sizeof(data); i++)
+        sprintf(digits + 2 * i, "%02x", (unsigned char)data[i]);
+    ck_assert_int_gt(asprintf(&expected_output, "--- !hex %s\n...\n", digits), 0);
+
+    yaml_emitter_set_output_string(&emitter, output, sizeof(output), &written);
+    /* Do not wrap long lines */
+    yaml_emitter_set_width(&emitter, -1);
+
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+
+    ck_assert(yaml_emit_hex(&emitter, NULL, data, sizeof(data)));
+
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+
+    ck_assert_str_eq((char *)output, expected_output);
+
+    free(expected_output);
+    free(digits);
+}
+END_TEST
+
 static Suite *
 unit_suite(void)
 {
@@ -745,6 +1597,8 @@ unit_suite(void)
     tcase_add_test(tests, yei_zero);
     tcase_add_test(tests, yei_min);
     tcase_add_test(tests, yei_max);
+    /* 10^0 ... 10^18 */
+    tcase_add_loop_test(tests, yei_digits, 0, 19);
 
     suite_add_tcase(suite, tests);
 
@@ -752,6 +1606,22 @@ unit_suite(void)
     tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
     tcase_add_test(tests, yeui_zero);
     tcase_add_test(tests, yeui_max);
+    /* 10^0 ... 10^19 */
+    tcase_add_loop_test(tests, yeui_digits, 0, 20);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_emit_float");
+    tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
+    tcase_add_loop_test(tests, yef_values, 0, ARRAY_SIZE(FLOATS));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_emit_timestamp");
+    tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
+    tcase_add_loop_test(tests, yets_values, 0, ARRAY_SIZE(TIMESTAMPS));
+    tcase_add_test(tests, yets_same_day);
+    tcase_add_test(tests, yets_invalid);
 
     suite_add_tcase(suite, tests);
 
@@ -771,6 +1641,34 @@ unit_suite(void)
 
     suite_add_tcase(suite, tests);
 
+    tests = tcase_create("yaml_emit_binary_scratch");
+    tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
+    tcase_add_test(tests, yebisc_basic);
+    tcase_add_test(tests, yebisc_grow);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_emit_binary_stream");
+    tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
+    tcase_add_test(tests, yebis_basic);
+    tcase_add_test(tests, yebis_lines);
+    tcase_add_loop_test(tests, yebis_layouts, 0,
+                        LAYOUT_COUNT * ARRAY_SIZE(BINARY_SIZES));
+    tcase_add_test(tests, yebis_deep);
+    tcase_add_loop_test(tests, yebis_indent, 0,
+                        LAYOUT_FLOW * ARRAY_SIZE(INDENTS));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_emit_hex");
+    tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
+    tcase_add_test(tests, yeh_default_tag);
+    tcase_add_loop_test(tests, yeh_digits, 0, ARRAY_SIZE(DIGIT_IDS));
+    tcase_add_test(tests, yeh_tagged);
+    tcase_add_test(tests, yeh_loooong);
+
+    suite_add_tcase(suite, tests);
+
     return suite;
 }
 
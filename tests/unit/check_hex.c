@@ -0,0 +1,249 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <check.h>
+#include <miniyaml.h>
+
+#include "../../src/hex.h"
+
+#ifndef ARRAY_SIZE
+# define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+#endif
+
+/* Up to 3 SIMD blocks, and every possible tail */
+#define MAX_SIZE 64
+
+static void
+random_bytes(char *dest, size_t n, uint64_t seed)
+{
+    uint64_t x = seed * 0x9e3779b97f4a7c15ULL + 1;
+
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        dest[i] = x >> 56;
+    }
+}
+
+/* The obvious implementation */
+static void
+reference_encode(char *dest, const char *src, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        sprintf(dest + 2 * i, "%02x", (unsigned char)src[i]);
+    dest[2 * n] = '\0';
+}
+
+/*----------------------------------------------------------------------------*
+ |                                hex_encode()                                |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(he_nothing)
+{
+    char c = 'x';
+
+    ck_assert_uint_eq(hex_encode(&c, NULL, 0), 0);
+    ck_assert_int_eq(c, '\0');
+}
+END_TEST
+
+START_TEST(he_every_byte)
+{
+    char output[2 * 256 + 1];
+    char expected[2 * 256 + 1];
+    char input[256];
+
+    for (size_t i = 0; i < sizeof(input); i++)
+        input[i] = i;
+
+    reference_encode(expected, input, sizeof(input));
+    ck_assert_uint_eq(hex_encode(output, input, sizeof(input)),
+                      2 * sizeof(input));
+    ck_assert_str_eq(output, expected);
+}
+END_TEST
+
+START_TEST(he_sizes)
+{
+    char output[2 * MAX_SIZE + 2];
+    char expected[2 * MAX_SIZE + 1];
+    char input[MAX_SIZE];
+
+    random_bytes(input, _i, _i);
+    reference_encode(expected, input, _i);
+
+    /* Nothing is written past the null byte */
+    memset(output, 'x', sizeof(output));
+    ck_assert_uint_eq(hex_encode(output, input, _i), 2 * _i);
+    ck_assert_str_eq(output, expected);
+    ck_assert_int_eq(output[2 * _i + 1], 'x');
+}
+END_TEST
+
+START_TEST(he_identifiers)
+{
+    char expected[2 * 32 + 1];
+    char output[2 * 32 + 1];
+    char input[32];
+
+    random_bytes(input, sizeof(input), 42);
+
+    reference_encode(expected, input, 16);
+    ck_assert_uint_eq(hex_encode_16(output, input), 32);
+    ck_assert_str_eq(output, expected);
+
+    reference_encode(expected, input, 20);
+    ck_assert_uint_eq(hex_encode_20(output, input), 40);
+    ck_assert_str_eq(output, expected);
+
+    reference_encode(expected, input, 32);
+    ck_assert_uint_eq(hex_encode_32(output, input), 64);
+    ck_assert_str_eq(output, expected);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                                hex_decode()                                |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(hd_sizes)
+{
+    char encoded[2 * MAX_SIZE + 1];
+    char output[MAX_SIZE];
+    char input[MAX_SIZE];
+
+    random_bytes(input, _i, _i);
+    reference_encode(encoded, input, _i);
+
+    ck_assert_int_eq(hex_decode(output, encoded, 2 * _i), _i);
+    ck_assert_mem_eq(output, input, _i);
+
+    /* Upper case */
+    for (size_t i = 0; i < 2 * _i; i++)
+        encoded[i] = toupper(encoded[i]);
+    ck_assert_int_eq(hex_decode(output, encoded, 2 * _i), _i);
+    ck_assert_mem_eq(output, input, _i);
+}
+END_TEST
+
+/* Every character, in every position of a SIMD block and of the tail */
+START_TEST(hd_every_character)
+{
+    char encoded[2 * 20];
+    char output[20];
+
+    for (size_t position = 0; position < sizeof(encoded); position++) {
+        for (unsigned int c = 0; c < 256; c++) {
+            ssize_t rc;
+
+            memset(encoded, '0', sizeof(encoded));
+            encoded[position] = c;
+
+            errno = 0;
+            rc = hex_decode(output, encoded, sizeof(encoded));
+            if (isxdigit(c)) {
+                ck_assert_int_eq(rc, sizeof(output));
+                ck_assert_int_eq((unsigned char)output[position / 2],
+                                 strtoul((char []){ c, '\0' }, NULL, 16)
+                                 << (position % 2 ? 0 : 4));
+            } else {
+                ck_assert_int_eq(rc, -1);
+                ck_assert_int_eq(errno, EILSEQ);
+            }
+        }
+    }
+}
+END_TEST
+
+START_TEST(hd_odd)
+{
+    char output[MAX_SIZE];
+
+    errno = 0;
+    ck_assert_int_eq(hex_decode(output, "abc", 3), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+START_TEST(hd_identifiers)
+{
+    char encoded[2 * 32 + 1];
+    char output[32];
+    char input[32];
+
+    random_bytes(input, sizeof(input), 42);
+    reference_encode(encoded, input, sizeof(input));
+
+    ck_assert_int_eq(hex_decode_16(output, encoded), 16);
+    ck_assert_mem_eq(output, input, 16);
+    ck_assert_int_eq(hex_decode_20(output, encoded), 20);
+    ck_assert_mem_eq(output, input, 20);
+    ck_assert_int_eq(hex_decode_32(output, encoded), 32);
+    ck_assert_mem_eq(output, input, 32);
+
+    encoded[31] = 'g';
+    errno = 0;
+    ck_assert_int_eq(hex_decode_16(output, encoded), -1);
+    ck_assert_int_eq(errno, EILSEQ);
+}
+END_TEST
+
+static Suite *
+unit_suite(void)
+{
+    Suite *suite;
+    TCase *tests;
+
+    suite = suite_create("hex");
+
+    tests = tcase_create("hex_encode");
+    tcase_add_test(tests, he_nothing);
+    tcase_add_test(tests, he_every_byte);
+    tcase_add_loop_test(tests, he_sizes, 0, MAX_SIZE + 1);
+    tcase_add_test(tests, he_identifiers);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("hex_decode");
+    tcase_add_loop_test(tests, hd_sizes, 0, MAX_SIZE + 1);
+    tcase_add_test(tests, hd_every_character);
+    tcase_add_test(tests, hd_odd);
+    tcase_add_test(tests, hd_identifiers);
+
+    suite_add_tcase(suite, tests);
+
+    return suite;
+}
+
+int
+main(void)
+{
+    int number_failed;
+    SRunner *runner;
+    Suite *suite;
+
+    suite = unit_suite();
+    runner = srunner_create(suite);
+
+    srunner_run_all(runner, CK_NORMAL);
+    number_failed = srunner_ntests_failed(runner);
+    srunner_free(runner);
+
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,399 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <check.h>
+
+#include <miniyaml.h>
+
+#ifndef ARRAY_SIZE
+# define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+#endif
+
+static yaml_parser_t parser;
+static yaml_emitter_t emitter;
+
+static void
+parser_init(void)
+{
+    ck_assert(yaml_parser_initialize(&parser));
+}
+
+static void
+parser_exit(void)
+{
+    yaml_parser_delete(&parser);
+}
+
+static void
+emitter_init(void)
+{
+    ck_assert(yaml_emitter_initialize(&emitter));
+}
+
+static void
+emitter_exit(void)
+{
+    yaml_emitter_delete(&emitter);
+}
+
+/* Create a temporary file that holds @content, return its path */
+static char *
+make_file(const char *content)
+{
+    char *path = strdup("/tmp/check_io.XXXXXX");
+    size_t length = strlen(content);
+    int fd;
+
+    ck_assert_ptr_nonnull(path);
+    fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, content, length), length);
+    ck_assert_int_eq(close(fd), 0);
+
+    return path;
+}
+
+static void
+ck_assert_event_type(yaml_parser_t *parser, yaml_event_type_t type)
+{
+    yaml_event_t event;
+
+    ck_assert(yaml_parser_parse(parser, &event));
+    ck_assert_int_eq(event.type, type);
+    yaml_event_delete(&event);
+}
+
+static void
+ck_assert_scalar(yaml_parser_t *parser, const char *value)
+{
+    yaml_event_t event;
+
+    ck_assert(yaml_parser_parse(parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+    ck_assert_str_eq(yaml_scalar_value(&event), value);
+    yaml_event_delete(&event);
+}
+
+/* "--- a\n--- b\n" */
+static void
+ck_assert_a_b(yaml_parser_t *parser)
+{
+    ck_assert_event_type(parser, YAML_STREAM_START_EVENT);
+    ck_assert_event_type(parser, YAML_DOCUMENT_START_EVENT);
+    ck_assert_scalar(parser, "a");
+    ck_assert_event_type(parser, YAML_DOCUMENT_END_EVENT);
+    ck_assert_event_type(parser, YAML_DOCUMENT_START_EVENT);
+    ck_assert_scalar(parser, "b");
+    ck_assert_event_type(parser, YAML_DOCUMENT_END_EVENT);
+    ck_assert_event_type(parser, YAML_STREAM_END_EVENT);
+}
+
+/*----------------------------------------------------------------------------*
+ |                        yaml_parser_set_input_mmap()                        |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(ypsim_file)
+{
+    char *path = make_file("--- a\n--- b\n");
+
+    ck_assert(yaml_parser_set_input_mmap(&parser, path));
+    ck_assert_a_b(&parser);
+    yaml_parser_unset_input_mmap(&parser);
+
+    unlink(path);
+    free(path);
+}
+END_TEST
+
+START_TEST(ypsim_empty)
+{
+    char *path = make_file("");
+
+    ck_assert(yaml_parser_set_input_mmap(&parser, path));
+    ck_assert_event_type(&parser, YAML_STREAM_START_EVENT);
+    ck_assert_event_type(&parser, YAML_STREAM_END_EVENT);
+    yaml_parser_unset_input_mmap(&parser);
+
+    unlink(path);
+    free(path);
+}
+END_TEST
+
+START_TEST(ypsim_skip)
+{
+    char *path = make_file("--- a\n--- b\n");
+
+    ck_assert(yaml_parser_set_input_mmap(&parser, path));
+    ck_assert_event_type(&parser, YAML_STREAM_START_EVENT);
+    ck_assert_event_type(&parser, YAML_DOCUMENT_START_EVENT);
+    ck_assert(yaml_parser_skip(&parser, YAML_DOCUMENT_START_EVENT));
+    ck_assert_event_type(&parser, YAML_DOCUMENT_START_EVENT);
+    ck_assert_scalar(&parser, "b");
+    yaml_parser_unset_input_mmap(&parser);
+
+    unlink(path);
+    free(path);
+}
+END_TEST
+
+START_TEST(ypsim_pipe)
+{
+    const char INPUT[] = "--- a\n--- b\n";
+    char path[64];
+    int fds[2];
+
+    ck_assert_int_eq(pipe(fds), 0);
+    ck_assert_int_eq(write(fds[1], INPUT, sizeof(INPUT) - 1),
+                     sizeof(INPUT) - 1);
+    ck_assert_int_eq(close(fds[1]), 0);
+    sprintf(path, "/dev/fd/%d", fds[0]);
+
+    ck_assert(yaml_parser_set_input_mmap(&parser, path));
+    ck_assert_a_b(&parser);
+    yaml_parser_unset_input_mmap(&parser);
+
+    ck_assert_int_eq(close(fds[0]), 0);
+}
+END_TEST
+
+static const struct {
+    const char *path;
+    int error;
+} INVALID_PATHS[] = {
+    { "/does/not/exist", ENOENT },
+    { "/", EISDIR },
+};
+
+START_TEST(ypsim_invalid)
+{
+    errno = 0;
+    ck_assert(!yaml_parser_set_input_mmap(&parser, INVALID_PATHS[_i].path));
+    ck_assert_int_eq(errno, INVALID_PATHS[_i].error);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                         yaml_parser_set_input_fd()                         |
+ *----------------------------------------------------------------------------*/
+
+static const size_t BLOCK_SIZES[] = { 0, 1, 4, 4096, 1 << 20 };
+
+START_TEST(ypsif_file)
+{
+    char *path = make_file("--- a\n--- b\n");
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    ck_assert_int_ge(fd, 0);
+
+    ck_assert(yaml_parser_set_input_fd(&parser, fd, BLOCK_SIZES[_i]));
+    ck_assert_a_b(&parser);
+    yaml_parser_unset_input_fd(&parser);
+
+    ck_assert_int_eq(close(fd), 0);
+    unlink(path);
+    free(path);
+}
+END_TEST
+
+START_TEST(ypsif_offset)
+{
+    char *path = make_file("garbage--- a\n--- b\n");
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(lseek(fd, strlen("garbage"), SEEK_SET), strlen("garbage"));
+
+    ck_assert(yaml_parser_set_input_fd(&parser, fd, BLOCK_SIZES[_i]));
+    ck_assert_a_b(&parser);
+    yaml_parser_unset_input_fd(&parser);
+
+    ck_assert_int_eq(close(fd), 0);
+    unlink(path);
+    free(path);
+}
+END_TEST
+
+START_TEST(ypsif_pipe)
+{
+    const char INPUT[] = "--- a\n--- b\n";
+    int fds[2];
+
+    ck_assert_int_eq(pipe(fds), 0);
+    ck_assert_int_eq(write(fds[1], INPUT, sizeof(INPUT) - 1),
+                     sizeof(INPUT) - 1);
+    ck_assert_int_eq(close(fds[1]), 0);
+
+    ck_assert(yaml_parser_set_input_fd(&parser, fds[0], BLOCK_SIZES[_i]));
+    ck_assert_a_b(&parser);
+    yaml_parser_unset_input_fd(&parser);
+
+    ck_assert_int_eq(close(fds[0]), 0);
+}
+END_TEST
+
+START_TEST(ypsif_invalid)
+{
+    ck_assert(yaml_parser_set_input_fd(&parser, -1, BLOCK_SIZES[_i]));
+    ck_assert(!yaml_parser_parse(&parser, &(yaml_event_t){}));
+    ck_assert_int_eq(parser.error, YAML_READER_ERROR);
+    yaml_parser_unset_input_fd(&parser);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                        yaml_emitter_set_output_fd()                        |
+ *----------------------------------------------------------------------------*/
+
+#define A_B "--- \"a\"\n...\n--- \"b\"\n...\n"
+
+/* Emit A_B */
+static void
+ck_emit_a_b(yaml_emitter_t *emitter)
+{
+    ck_assert(yaml_emit_stream_start(emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(emitter));
+    ck_assert(YAML_EMIT_STRING(emitter, "a"));
+    ck_assert(yaml_emit_document_end(emitter));
+    ck_assert(yaml_emit_document_start(emitter));
+    ck_assert(YAML_EMIT_STRING(emitter, "b"));
+    ck_assert(yaml_emit_document_end(emitter));
+    ck_assert(yaml_emit_stream_end(emitter));
+}
+
+START_TEST(yesof_file)
+{
+    char *path = make_file("");
+    char output[64];
+    ssize_t length;
+    int fd;
+
+    fd = open(path, O_RDWR);
+    ck_assert_int_ge(fd, 0);
+
+    ck_assert(yaml_emitter_set_output_fd(&emitter, fd, BLOCK_SIZES[_i]));
+    ck_emit_a_b(&emitter);
+    ck_assert(yaml_emitter_unset_output_fd(&emitter));
+
+    length = pread(fd, output, sizeof(output), 0);
+    ck_assert_int_ge(length, 0);
+    output[length] = '\0';
+    ck_assert_str_eq(output, A_B);
+
+    ck_assert_int_eq(close(fd), 0);
+    unlink(path);
+    free(path);
+}
+END_TEST
+
+/* Nothing is written before the block is full, or the output unset */
+START_TEST(yesof_block)
+{
+    char output[64];
+    ssize_t length;
+    int fds[2];
+
+    ck_assert_int_eq(pipe(fds), 0);
+    ck_assert_int_eq(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+
+    ck_assert(yaml_emitter_set_output_fd(&emitter, fds[1], 1 << 20));
+    ck_emit_a_b(&emitter);
+    ck_assert(yaml_emitter_flush(&emitter));
+    ck_assert_int_eq(read(fds[0], output, sizeof(output)), -1);
+    ck_assert_int_eq(errno, EAGAIN);
+
+    ck_assert(yaml_emitter_unset_output_fd(&emitter));
+    length = read(fds[0], output, sizeof(output) - 1);
+    ck_assert_int_ge(length, 0);
+    output[length] = '\0';
+    ck_assert_str_eq(output, A_B);
+
+    ck_assert_int_eq(close(fds[0]), 0);
+    ck_assert_int_eq(close(fds[1]), 0);
+}
+END_TEST
+
+START_TEST(yesof_invalid)
+{
+    ck_assert(yaml_emitter_set_output_fd(&emitter, -1, BLOCK_SIZES[_i]));
+    /* libyaml does not write anything before the end of the document */
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(YAML_EMIT_STRING(&emitter, "a"));
+
+    errno = 0;
+    ck_assert(!yaml_emitter_unset_output_fd(&emitter));
+    ck_assert_int_eq(errno, EBADF);
+}
+END_TEST
+
+static Suite *
+unit_suite(void)
+{
+    Suite *suite;
+    TCase *tests;
+
+    suite = suite_create("io");
+
+    tests = tcase_create("yaml_parser_set_input_mmap");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_test(tests, ypsim_file);
+    tcase_add_test(tests, ypsim_empty);
+    tcase_add_test(tests, ypsim_skip);
+    tcase_add_test(tests, ypsim_pipe);
+    tcase_add_loop_test(tests, ypsim_invalid, 0, ARRAY_SIZE(INVALID_PATHS));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parser_set_input_fd");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ypsif_file, 0, ARRAY_SIZE(BLOCK_SIZES));
+    tcase_add_loop_test(tests, ypsif_offset, 0, ARRAY_SIZE(BLOCK_SIZES));
+    tcase_add_loop_test(tests, ypsif_pipe, 0, ARRAY_SIZE(BLOCK_SIZES));
+    tcase_add_loop_test(tests, ypsif_invalid, 0, ARRAY_SIZE(BLOCK_SIZES));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_emitter_set_output_fd");
+    tcase_add_checked_fixture(tests, emitter_init, emitter_exit);
+    tcase_add_loop_test(tests, yesof_file, 0, ARRAY_SIZE(BLOCK_SIZES));
+    tcase_add_test(tests, yesof_block);
+    tcase_add_loop_test(tests, yesof_invalid, 0, ARRAY_SIZE(BLOCK_SIZES));
+
+    suite_add_tcase(suite, tests);
+
+    return suite;
+}
+
+int
+main(void)
+{
+    int number_failed;
+    SRunner *runner;
+    Suite *suite;
+
+    suite = unit_suite();
+    runner = srunner_create(suite);
+
+    srunner_run_all(runner, CK_NORMAL);
+    number_failed = srunner_ntests_failed(runner);
+    srunner_free(runner);
+
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,227 @@
+/* This file is part of MiniYAML
+ * Copyright (C) 2019 Commissariat a l'energie atomique et aux energies
+ *                    alternatives
+ *
+ * SPDX-License-Identifer: LGPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <check.h>
+
+#include <miniyaml.h>
+
+#ifndef ARRAY_SIZE
+# define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+#endif
+
+/* Enough documents for every thread to get several batches */
+#define DOCUMENT_COUNT (1 << 16)
+
+static const unsigned int THREADS[] = { 0, 1, 2, 3, 8, 64, 1024 };
+
+/* A stream of DOCUMENT_COUNT documents: "--- <i>\n" */
+static char *
+make_stream(size_t *length)
+{
+    char *stream = malloc(DOCUMENT_COUNT * sizeof("--- 65535\n"));
+    size_t offset = 0;
+
+    ck_assert_ptr_nonnull(stream);
+    for (size_t i = 0; i < DOCUMENT_COUNT; i++)
+        offset += sprintf(stream + offset, "--- %zu\n", i);
+
+    *length = offset;
+    return stream;
+}
+
+/* Documents hold their own index */
+static void *
+parse_index(yaml_parser_t *parser, size_t index, void *data)
+{
+    uintmax_t value = SIZE_MAX;
+    yaml_event_t event;
+
+    if (!yaml_parser_parse(parser, &event))
+        return NULL;
+
+    if (event.type == YAML_SCALAR_EVENT
+     && yaml_parse_unsigned_integer(&event, &value) && value == index)
+        value = index + 1;
+    yaml_event_delete(&event);
+
+    if (!yaml_parser_skip(parser, YAML_DOCUMENT_START_EVENT))
+        return NULL;
+
+    /* NULL means the document was not parsed as it should have been */
+    return (void *)(uintptr_t)(value == index + 1 ? value : 0);
+}
+
+struct deliveries {
+    size_t count;
+    /* The index of the document expected to be delivered next, at least */
+    size_t next;
+    /* How many times each document was delivered */
+    unsigned char *seen;
+    /* Whether results were delivered in order */
+    bool ordered;
+    bool valid;
+};
+
+static void
+deliver_index(void *result, size_t index, void *data)
+{
+    struct deliveries *deliveries = data;
+
+    deliveries->ordered &= index >= deliveries->next;
+    deliveries->next = index + 1;
+    deliveries->valid &= (uintptr_t)result == index + 1;
+    deliveries->seen[index]++;
+    deliveries->count++;
+}
+
+static void
+ck_assert_parallel_parse(const char *input, size_t length, size_t count,
+                         unsigned int threads, bool ordered)
+{
+    struct deliveries deliveries = {
+        .seen = calloc(count + 1, 1),
+        .ordered = true,
+        .valid = true,
+    };
+
+    ck_assert_ptr_nonnull(deliveries.seen);
+
+    ck_assert(yaml_parallel_parse(input, length, threads, ordered,
+                                  parse_index, deliver_index, &deliveries));
+    ck_assert_uint_eq(deliveries.count, count);
+    ck_assert(deliveries.valid);
+    if (ordered)
+        ck_assert(deliveries.ordered);
+    for (size_t i = 0; i < count; i++)
+        ck_assert_uint_eq(deliveries.seen[i], 1);
+
+    free(deliveries.seen);
+}
+
+/*----------------------------------------------------------------------------*
+ |                           yaml_parallel_parse()                            |
+ *----------------------------------------------------------------------------*/
+
+START_TEST(ypp_ordered)
+{
+    size_t length;
+    char *input;
+
+    input = make_stream(&length);
+    ck_assert_parallel_parse(input, length, DOCUMENT_COUNT, THREADS[_i], true);
+    free(input);
+}
+END_TEST
+
+START_TEST(ypp_unordered)
+{
+    size_t length;
+    char *input;
+
+    input = make_stream(&length);
+    ck_assert_parallel_parse(input, length, DOCUMENT_COUNT, THREADS[_i], false);
+    free(input);
+}
+END_TEST
+
+static const struct {
+    const char *input;
+    size_t count;
+} SMALL_STREAMS[] = {
+    { "", 0 },
+    { "# comment\n", 0 },
+    { "0", 1 },
+    { "0\n--- 1\n...\n%YAML 1.1\n--- 2\n", 3 },
+};
+
+START_TEST(ypp_small)
+{
+    const char *INPUT = SMALL_STREAMS[_i].input;
+
+    ck_assert_parallel_parse(INPUT, strlen(INPUT), SMALL_STREAMS[_i].count, 4,
+                             true);
+    ck_assert_parallel_parse(INPUT, strlen(INPUT), SMALL_STREAMS[_i].count, 4,
+                             false);
+}
+END_TEST
+
+START_TEST(ypp_error)
+{
+    struct deliveries deliveries = {
+        .ordered = true,
+        .valid = true,
+    };
+    size_t length;
+    char *input;
+
+    input = make_stream(&length);
+    deliveries.seen = calloc(DOCUMENT_COUNT, 1);
+    ck_assert_ptr_nonnull(deliveries.seen);
+
+    /* Break the document in the middle of the stream */
+    strstr(input, "--- 32768\n")[4] = '[';
+
+    errno = 0;
+    ck_assert(!yaml_parallel_parse(input, length, 4, true, parse_index,
+                                   deliver_index, &deliveries));
+    ck_assert_int_eq(errno, EINVAL);
+
+    /* Whatever was parsed is delivered, in order */
+    ck_assert(deliveries.ordered);
+    ck_assert_uint_lt(deliveries.count, DOCUMENT_COUNT);
+    for (size_t i = 0; i < DOCUMENT_COUNT; i++)
+        ck_assert_uint_le(deliveries.seen[i], 1);
+
+    free(deliveries.seen);
+    free(input);
+}
+END_TEST
+
+static Suite *
+unit_suite(void)
+{
+    Suite *suite;
+    TCase *tests;
+
+    suite = suite_create("parallel");
+
+    tests = tcase_create("yaml_parallel_parse");
+    tcase_add_loop_test(tests, ypp_ordered, 0, ARRAY_SIZE(THREADS));
+    tcase_add_loop_test(tests, ypp_unordered, 0, ARRAY_SIZE(THREADS));
+    tcase_add_loop_test(tests, ypp_small, 0, ARRAY_SIZE(SMALL_STREAMS));
+    tcase_add_test(tests, ypp_error);
+
+    suite_add_tcase(suite, tests);
+
+    return suite;
+}
+
+int
+main(void)
+{
+    int number_failed;
+    SRunner *runner;
+    Suite *suite;
+
+    suite = unit_suite();
+    runner = srunner_create(suite);
+
+    srunner_run_all(runner, CK_NORMAL);
+    number_failed = srunner_ntests_failed(runner);
+    srunner_free(runner);
+
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -11,6 +11,8 @@
 
 #include <check.h>
 #include <errno.h>
+#include <float.h>
+#include <math.h>
 
 #include <miniyaml.h>
 
@@ -225,6 +227,200 @@ START_TEST(ys_double_quoted)
 }
 END_TEST
 
+/*----------------------------------------------------------------------------*
+ |                            yaml_scalar_match()                             |
+ *----------------------------------------------------------------------------*/
+
+enum access {
+    ACCESS_NONE,
+    ACCESS_READ_ONLY,
+    ACCESS_READ_WRITE,
+    ACCESS_ALL,
+};
+
+static const struct yaml_keyword ACCESSES[] = {
+    { "none", ACCESS_NONE },
+    { "ro", ACCESS_READ_ONLY },
+    { "rw", ACCESS_READ_WRITE },
+    { "all", ACCESS_ALL },
+    { "readonly", ACCESS_READ_ONLY },
+    { "rw-all_1", ACCESS_ALL },
+};
+
+static const struct {
+    const char *input;
+    bool fold_case;
+    bool match;
+    enum access access;
+} SCALAR_MATCHES[] = {
+    { "none", false, true, ACCESS_NONE },
+    { "ro", false, true, ACCESS_READ_ONLY },
+    { "rw", false, true, ACCESS_READ_WRITE },
+    { "all", false, true, ACCESS_ALL },
+    { "'all'", false, true, ACCESS_ALL },
+    { "readonly", false, true, ACCESS_READ_ONLY },
+    { "rw-all_1", false, true, ACCESS_ALL },
+    { "RO", false, false, 0 },
+    { "RO", true, true, ACCESS_READ_ONLY },
+    { "Ro", true, true, ACCESS_READ_ONLY },
+    { "ReadOnly", true, false, 0 },
+    { "READONLY", true, true, ACCESS_READ_ONLY },
+    { "RW-ALL_1", true, true, ACCESS_ALL },
+    { "Rw-all_1", true, true, ACCESS_ALL },
+    { "rW", true, false, 0 },
+    { "''", false, false, 0 },
+    { "non", false, false, 0 },
+    { "nonee", false, false, 0 },
+    { "readonly!", false, false, 0 },
+    { "read-only", true, false, 0 },
+};
+
+START_TEST(ysm_values)
+{
+    const char *INPUT = SCALAR_MATCHES[_i].input;
+    yaml_event_t event;
+    int access = -1;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    if (SCALAR_MATCHES[_i].match) {
+        ck_assert(yaml_scalar_match(&event, ACCESSES, ARRAY_SIZE(ACCESSES),
+                                    SCALAR_MATCHES[_i].fold_case, &access));
+        ck_assert_int_eq(access, SCALAR_MATCHES[_i].access);
+    } else {
+        ck_assert(!yaml_scalar_match(&event, ACCESSES, ARRAY_SIZE(ACCESSES),
+                                     SCALAR_MATCHES[_i].fold_case, &access));
+        ck_assert_int_eq(errno, EINVAL);
+        ck_assert_int_eq(access, -1);
+    }
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                              yaml_tag2type()                               |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    const char *name;
+    enum yaml_type type;
+} YAML_TYPES[] = {
+    { "map", YT_MAP },
+    { "omap", YT_OMAP },
+    { "pairs", YT_PAIRS },
+    { "set", YT_SET },
+    { "seq", YT_SEQ },
+    { "binary", YT_BINARY },
+    { "bool", YT_BOOL },
+    { "float", YT_FLOAT },
+    { "int", YT_INT },
+    { "merge", YT_MERGE },
+    { "null", YT_NULL },
+    { "str", YT_STR },
+    { "timestamp", YT_TIMESTAMP },
+    { "value", YT_VALUE },
+    { "yaml", YT_YAML },
+};
+
+START_TEST(yt2t_uri)
+{
+    char *tag;
+
+    ck_assert_int_gt(asprintf(&tag, "tag:yaml.org,2002:%s",
+                              YAML_TYPES[_i].name), 0);
+    ck_assert_int_eq(yaml_tag2type(tag), YAML_TYPES[_i].type);
+    free(tag);
+}
+END_TEST
+
+START_TEST(yt2t_shorthand)
+{
+    char *tag;
+
+    ck_assert_int_gt(asprintf(&tag, "!!%s", YAML_TYPES[_i].name), 0);
+    ck_assert_int_eq(yaml_tag2type(tag), YAML_TYPES[_i].type);
+    free(tag);
+}
+END_TEST
+
+/* Tags are resolved as they are parsed */
+START_TEST(yt2t_parsed)
+{
+    const char INPUT[] = "!!timestamp 2001-12-14";
+    yaml_event_t event;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 sizeof(INPUT) - 1);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert_int_eq(yaml_tag2type(yaml_scalar_tag(&event)), YT_TIMESTAMP);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+static const char *UNKNOWN_YAML_TAGS[] = {
+    "tag:yaml.org,2002:",
+    "tag:yaml.org,2002:i",
+    "tag:yaml.org,2002:in",
+    "tag:yaml.org,2002:inT",
+    "tag:yaml.org,2002:intx",
+    "tag:yaml.org,2002:timestamps",
+    "tag:yaml.org,2002:integer",
+    "!!",
+    "!!mat",
+    "!!strr",
+};
+
+START_TEST(yt2t_unknown)
+{
+    errno = 0;
+    ck_assert_int_eq(yaml_tag2type(UNKNOWN_YAML_TAGS[_i]), YT_UNKNOWN);
+    ck_assert_int_eq(errno, EINVAL);
+}
+END_TEST
+
+static const char *LOCAL_TAGS[] = {
+    "",
+    "!",
+    "!int",
+    "!person",
+    "tag:yaml.org,2002",
+    "tag:example.com,2000:int",
+};
+
+START_TEST(yt2t_local)
+{
+    errno = 0;
+    ck_assert_int_eq(yaml_tag2type(LOCAL_TAGS[_i]), YT_UNKNOWN);
+    ck_assert_int_eq(errno, ENOTSUP);
+}
+END_TEST
+
 /*----------------------------------------------------------------------------*
  |                             yaml_parse_null()                              |
  *----------------------------------------------------------------------------*/
@@ -276,6 +472,10 @@ static const char *INVALID_NULLS[] = {
     "Nill",
     "Nul",
     "NUL",
+    /* Mixed case */
+    "nULL",
+    "NUll",
+    "nuLL",
     /* Bad tag */
     "!!nul",
     "!!binary MDEy",
@@ -428,6 +628,18 @@ static const char *INVALID_BOOLEANS[] = {
     "Yas",
     "ye",
     "yas",
+    /* Mixed case */
+    "tRUE",
+    "TRue",
+    "fALSE",
+    "yES",
+    "YeS",
+    "nO",
+    "oN",
+    "OfF",
+    /* Too long */
+    "truetrue",
+    "falsefalse",
     /* Bad tag */
     "!!boolean y",
     "!!null",
@@ -469,6 +681,9 @@ static const char *ZEROS[] = {
     "0",
     "00",
     "0x0",
+    "0o0",
+    "0b0",
+    "0_0",
     "!!int 0",
 };
 
@@ -503,6 +718,10 @@ static const char *SIXTEENS[] = {
     "+16",
     "020",
     "0x10",
+    "0X10",
+    "0o20",
+    "0b1_0000",
+    "1_6",
     "!!int '020'",
 };
 
@@ -537,6 +756,9 @@ static const char *MINUS_SIXTEENS[] = {
     "-16",
     "-020",
     "-0x10",
+    "-0X10",
+    "-0o20",
+    "-0b10000",
     "!!int \"-0x10\"",
 };
 
@@ -771,12 +993,26 @@ static const char *INVALID_INTEGERS[] = {
     "0x",
     "0xg",
     "f",
+    /* Bad base 8 (YAML 1.2) */
+    "0o",
+    "0o8",
+    /* Bad base 2 */
+    "0b",
+    "0b2",
+    /* Bad separators */
+    "_1",
+    "-_1",
+    "0x_",
+    /* Sign only */
+    "!!int '-'",
+    "+",
     /* Not a number */
     "~",
     "test",
     /* Not only a number */
     "0test",
     "0 test",
+    "12345678test",
     /* Not only one number */
     "0 1 2 3",
 };
@@ -809,6 +1045,53 @@ START_TEST(ypi_invalid)
 }
 END_TEST
 
+static const struct {
+    const char *input;
+    intmax_t value;
+} LONG_INTEGERS[] = {
+    { "12345678", 12345678 },
+    { "123456789", 123456789 },
+    { "-1234567890123456789", -1234567890123456789 },
+    { "1_234_567_890_123", 1234567890123 },
+    { "12345678_12345678", 1234567812345678 },
+    { "0x7fff_ffff_ffff_ffff", INTMAX_MAX },
+    { "0X7FFF_FFFF_FFFF_FFFF", INTMAX_MAX },
+    { "-0b1000000000000000000000000000000000000000000000000000000000000000",
+      INTMAX_MIN },
+    { "0o777", 0777 },
+    { "00000000000000000000017", 017 },
+};
+
+START_TEST(ypi_long)
+{
+    const char *INPUT = LONG_INTEGERS[_i].input;
+    yaml_event_t event;
+    intmax_t i;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    /* errno is left untouched on success */
+    errno = EBADF;
+    ck_assert(yaml_parse_integer(&event, &i));
+    ck_assert_int_eq(i, LONG_INTEGERS[_i].value);
+    ck_assert_int_eq(errno, EBADF);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
 START_TEST(ypi_too_little_base10)
 {
     yaml_event_t event;
@@ -1290,6 +1573,12 @@ static const char *INVALID_UNSIGNED_INTEGERS[] = {
     "0x",
     "f",
     "0xg",
+    /* Bad base 8 (YAML 1.2) */
+    "0o9",
+    /* Bad base 2 */
+    "0b12",
+    /* Bad separators */
+    "_0",
     /* Not a number */
     "~",
     "test",
@@ -1521,24 +1810,46 @@ START_TEST(ypui_too_big_base16)
 END_TEST
 
 /*----------------------------------------------------------------------------*
- |                            yaml_parse_string()                             |
+ |                   yaml_parse_int*(), yaml_parse_uint*()                    |
  *----------------------------------------------------------------------------*/
 
-static const char *ABCDEFGS[] = {
-    "abcdefg",
-    "'abcdefg'",
-    "\"abcdefg\"",
-    "!!str abcdefg",
-    "!!str 'abcdefg'",
-    "!!str \"abcdefg\"",
+static const struct {
+    const char *input;
+    unsigned int bits;
+    int error;
+    intmax_t value;
+} FIXED_WIDTH_INTEGERS[] = {
+    { "127", 8, 0, INT8_MAX },
+    { "-128", 8, 0, INT8_MIN },
+    { "0x7f", 8, 0, INT8_MAX },
+    { "-0b1000_0000", 8, 0, INT8_MIN },
+    { "128", 8, ERANGE, 0 },
+    { "-129", 8, ERANGE, 0 },
+    { "0x80", 8, ERANGE, 0 },
+    { "1000x", 8, EINVAL, 0 },
+    { "32767", 16, 0, INT16_MAX },
+    { "-32768", 16, 0, INT16_MIN },
+    { "32768", 16, ERANGE, 0 },
+    { "-32769", 16, ERANGE, 0 },
+    { "2147483647", 32, 0, INT32_MAX },
+    { "-2147483648", 32, 0, INT32_MIN },
+    { "-2_147_483_648", 32, 0, INT32_MIN },
+    { "2147483648", 32, ERANGE, 0 },
+    { "-2147483649", 32, ERANGE, 0 },
+    { "21474836470000000000", 32, ERANGE, 0 },
+    { "9223372036854775807", 64, 0, INT64_MAX },
+    { "-9223372036854775808", 64, 0, INT64_MIN },
+    { "9223372036854775808", 64, ERANGE, 0 },
+    { "-9223372036854775809", 64, ERANGE, 0 },
+    { "!!str 0", 64, EINVAL, 0 },
 };
 
-START_TEST(yps_abcdefg)
+START_TEST(ypfwi_values)
 {
-    const char *INPUT = ABCDEFGS[_i];
+    const char *INPUT = FIXED_WIDTH_INTEGERS[_i].input;
     yaml_event_t event;
-    const char *string;
-    size_t size;
+    intmax_t value;
+    bool success;
 
     yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
                                  strlen(INPUT));
@@ -1554,27 +1865,85 @@ START_TEST(yps_abcdefg)
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
-    ck_assert(yaml_parse_string(&event, &string, &size));
-    ck_assert_uint_eq(size, strlen(ABCDEFGS[0]));
-    ck_assert_str_eq(string, ABCDEFGS[0]);
+    errno = 0;
+    switch (FIXED_WIDTH_INTEGERS[_i].bits) {
+    case 8: {
+        int8_t i = 1;
+
+        success = yaml_parse_int8(&event, &i);
+        value = i;
+        break;
+    }
+    case 16: {
+        int16_t i = 1;
+
+        success = yaml_parse_int16(&event, &i);
+        value = i;
+        break;
+    }
+    case 32: {
+        int32_t i = 1;
+
+        success = yaml_parse_int32(&event, &i);
+        value = i;
+        break;
+    }
+    case 64: {
+        int64_t i = 1;
+
+        success = yaml_parse_int64(&event, &i);
+        value = i;
+        break;
+    }
+    default:
+        ck_abort();
+    }
+
+    if (FIXED_WIDTH_INTEGERS[_i].error) {
+        ck_assert(!success);
+        ck_assert_int_eq(errno, FIXED_WIDTH_INTEGERS[_i].error);
+        /* Left untouched */
+        ck_assert_int_eq(value, 1);
+    } else {
+        ck_assert(success);
+        ck_assert_int_eq(errno, 0);
+        ck_assert_int_eq(value, FIXED_WIDTH_INTEGERS[_i].value);
+    }
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-/* Any plain scalar can be a string */
-static const char *VALID_STRINGS[] = {
-    "~", /* Null */
-    "y", /* Boolean */
-    "0", /* Integer */
+static const struct {
+    const char *input;
+    unsigned int bits;
+    int error;
+    uintmax_t value;
+} FIXED_WIDTH_UNSIGNED_INTEGERS[] = {
+    { "255", 8, 0, UINT8_MAX },
+    { "0o377", 8, 0, UINT8_MAX },
+    { "-0", 8, 0, 0 },
+    { "256", 8, ERANGE, 0 },
+    { "-1", 8, ERANGE, 0 },
+    { "1000x", 8, EINVAL, 0 },
+    { "65535", 16, 0, UINT16_MAX },
+    { "65536", 16, ERANGE, 0 },
+    { "4294967295", 32, 0, UINT32_MAX },
+    { "0xffff_ffff", 32, 0, UINT32_MAX },
+    { "4294967296", 32, ERANGE, 0 },
+    { "42949672960000000000", 32, ERANGE, 0 },
+    { "18446744073709551615", 64, 0, UINT64_MAX },
+    { "18446744073709551616", 64, ERANGE, 0 },
+    { "-1", 64, ERANGE, 0 },
+    { "!!float 0", 64, EINVAL, 0 },
 };
 
-START_TEST(yps_valid_string)
+START_TEST(ypfwu_values)
 {
-    const char *INPUT = VALID_STRINGS[_i];
+    const char *INPUT = FIXED_WIDTH_UNSIGNED_INTEGERS[_i].input;
     yaml_event_t event;
-    const char *string;
-    size_t size;
+    uintmax_t value;
+    bool success;
 
     yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
                                  strlen(INPUT));
@@ -1590,21 +1959,96 @@ START_TEST(yps_valid_string)
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
-    ck_assert(yaml_parse_string(&event, &string, &size));
-    ck_assert_uint_eq(size, strlen(INPUT));
-    ck_assert_str_eq(string, INPUT);
+    errno = 0;
+    switch (FIXED_WIDTH_UNSIGNED_INTEGERS[_i].bits) {
+    case 8: {
+        uint8_t u = 1;
+
+        success = yaml_parse_uint8(&event, &u);
+        value = u;
+        break;
+    }
+    case 16: {
+        uint16_t u = 1;
+
+        success = yaml_parse_uint16(&event, &u);
+        value = u;
+        break;
+    }
+    case 32: {
+        uint32_t u = 1;
+
+        success = yaml_parse_uint32(&event, &u);
+        value = u;
+        break;
+    }
+    case 64: {
+        uint64_t u = 1;
+
+        success = yaml_parse_uint64(&event, &u);
+        value = u;
+        break;
+    }
+    default:
+        ck_abort();
+    }
+
+    if (FIXED_WIDTH_UNSIGNED_INTEGERS[_i].error) {
+        ck_assert(!success);
+        ck_assert_int_eq(errno, FIXED_WIDTH_UNSIGNED_INTEGERS[_i].error);
+        /* Left untouched */
+        ck_assert_uint_eq(value, 1);
+    } else {
+        ck_assert(success);
+        ck_assert_int_eq(errno, 0);
+        ck_assert_uint_eq(value, FIXED_WIDTH_UNSIGNED_INTEGERS[_i].value);
+    }
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-START_TEST(yps_no_size)
+/*----------------------------------------------------------------------------*
+ |                             yaml_parse_float()                             |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    const char *input;
+    double value;
+} VALID_FLOATS[] = {
+    { "0.0", 0. },
+    { "-0.0", -0. },
+    { "1", 1. },
+    { "1.", 1. },
+    { "-.5", -0.5 },
+    { "+1_000.5", 1000.5 },
+    { "1e5", 1e5 },
+    { "1E-5", 1e-5 },
+    { "6.02214076e+23", 6.02214076e23 },
+    { "0.1", 0.1 },
+    { "1.7976931348623157e+308", DBL_MAX },
+    { "2.2250738585072014e-308", DBL_MIN },
+    { "4.9406564584124654e-324", 5e-324 },
+    /* More than 19 significant digits */
+    { "0.1000000000000000055511151231257827021181583404541015625", 0.1 },
+    { "123456789012345678901234567890", 123456789012345678901234567890. },
+    { ".inf", INFINITY },
+    { "-.Inf", -INFINITY },
+    { "+.INF", INFINITY },
+    { ".nan", NAN },
+    { ".NaN", NAN },
+    { "!!float 1", 1. },
+    { "!!float '1.5'", 1.5 },
+};
+
+START_TEST(ypf_valid)
 {
-    const unsigned char INPUT[] = "test";
+    const char *INPUT = VALID_FLOATS[_i].input;
     yaml_event_t event;
-    const char *string;
+    double d;
 
-    yaml_parser_set_input_string(&parser, INPUT, sizeof(INPUT) - 1);
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
 
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
@@ -1617,25 +2061,48 @@ START_TEST(yps_no_size)
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
-    ck_assert(yaml_parse_string(&event, &string, NULL));
-    ck_assert_str_eq(string, (char *)INPUT);
+    ck_assert(yaml_parse_float(&event, &d));
+    if (isnan(VALID_FLOATS[_i].value)) {
+        ck_assert(isnan(d));
+    } else {
+        ck_assert(d == VALID_FLOATS[_i].value);
+        ck_assert_int_eq(signbit(d), signbit(VALID_FLOATS[_i].value));
+    }
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-static const char *INVALID_STRINGS[] = {
+static const char *INVALID_FLOATS[] = {
+    /* No tag, not plain */
+    "'0.0'",
+    "\"0.0\"",
     /* Bad tag */
-    "!!string test",
-    "!!s test",
-    "!!int test",
+    "!!int 0.0",
+    "!!str 0.0",
+    /* Empty */
+    "!!float",
+    /* Not a number */
+    ".",
+    "e1",
+    "_1.0",
+    "1e",
+    "1e+",
+    "0x10",
+    "1,5",
+    "-.nan",
+    ".infinity",
+    "~",
+    "test",
+    /* Not only a number */
+    "1.0 test",
 };
 
-START_TEST(yps_invalid_string)
+START_TEST(ypf_invalid)
 {
-    const char *INPUT = INVALID_STRINGS[_i];
+    const char *INPUT = INVALID_FLOATS[_i];
     yaml_event_t event;
-    const char *string;
+    double d;
 
     yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
                                  strlen(INPUT));
@@ -1652,30 +2119,24 @@ START_TEST(yps_invalid_string)
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
     errno = 0;
-    ck_assert(!yaml_parse_string(&event, &string, NULL));
+    ck_assert(!yaml_parse_float(&event, &d));
     ck_assert_int_eq(errno, EINVAL);
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-/*----------------------------------------------------------------------------*
- |                            yaml_parse_binary()                             |
- *----------------------------------------------------------------------------*/
-
-static const char *BINARY_ABCDEFGS[] = {
-    "YWJjZGVmZw==",
-    "!!binary YWJjZGVmZw==",
-    "!!binary 'YWJjZGVmZw=='",
-    "!!binary \"YWJjZGVmZw==\"",
+static const char *OUT_OF_RANGE_FLOATS[] = {
+    "1e400",
+    "-1.8e308",
+    "1e-400",
 };
 
-START_TEST(ypbi_abcdefg)
+START_TEST(ypf_out_of_range)
 {
-    const char *INPUT = BINARY_ABCDEFGS[_i];
-    char binary[sizeof(ABCDEFGS[0]) - 1];
+    const char *INPUT = OUT_OF_RANGE_FLOATS[_i];
     yaml_event_t event;
-    size_t size;
+    double d;
 
     yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
                                  strlen(INPUT));
@@ -1691,28 +2152,117 @@ START_TEST(ypbi_abcdefg)
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
-    ck_assert(yaml_parse_binary(&event, binary, &size));
-    ck_assert_uint_eq(size, sizeof(binary));
-    ck_assert_mem_eq(binary, ABCDEFGS[0], sizeof(binary));
+    errno = 0;
+    ck_assert(!yaml_parse_float(&event, &d));
+    ck_assert_int_eq(errno, ERANGE);
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-static const char *INVALID_BINARIES[] = {
-    /* Not plain */
-    "'AAAA'",
-    /* Bad tag */
-    "!!bin AAAA",
-    "!!str AAAA",
+/* yaml_emit_float() and yaml_parse_float() agree on every double */
+START_TEST(ypf_round_trip)
+{
+    unsigned char input[64 * 1024];
+    yaml_emitter_t emitter;
+    uint64_t x = 88172645463325252ULL;
+    double values[1000];
+    size_t written = 0;
+    yaml_event_t event;
+
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        memcpy(&values[i], &x, sizeof(values[i]));
+        /* Round numbers are easy to get wrong too */
+        if (i % 2)
+            values[i] = (double)(x % 1000000) / 1000;
+    }
+
+    ck_assert(yaml_emitter_initialize(&emitter));
+    yaml_emitter_set_output_string(&emitter, input, sizeof(input), &written);
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++)
+        ck_assert(yaml_emit_float(&emitter, values[i]));
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+    yaml_emitter_delete(&emitter);
+
+    yaml_parser_set_input_string(&parser, input, written);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SEQUENCE_START_EVENT);
+    yaml_event_delete(&event);
+
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        double d;
+
+        ck_assert(yaml_parser_parse(&parser, &event));
+        ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+        ck_assert(yaml_parse_float(&event, &d));
+        if (isnan(values[i]))
+            ck_assert(isnan(d));
+        else
+            ck_assert_mem_eq(&d, &values[i], sizeof(d));
+
+        yaml_event_delete(&event);
+    }
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                           yaml_parse_timestamp()                           |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    const char *input;
+    struct timespec ts;
+} VALID_TIMESTAMPS[] = {
+    /* Canonical */
+    { "2001-12-14T21:59:43.100000000Z", { 1008367183, 100000000 } },
+    { "2001-12-14T21:59:43Z", { 1008367183, 0 } },
+    { "1969-12-31T23:59:59.999999999Z", { -1, 999999999 } },
+    { "2000-02-29T00:00:00Z", { 951782400, 0 } },
+    { "0000-01-01T00:00:00Z", { -62167219200, 0 } },
+    /* Date only */
+    { "2002-12-14", { 1039824000, 0 } },
+    /* Time zones */
+    { "2001-12-14t21:59:43.10-05:00", { 1008385183, 100000000 } },
+    { "2001-12-14 21:59:43.10 -5", { 1008385183, 100000000 } },
+    { "2001-12-15 2:59:43.10", { 1008385183, 100000000 } },
+    { "2001-12-15T02:59:43.1Z", { 1008385183, 100000000 } },
+    { "2001-12-15 02:59:43.1 Z", { 1008385183, 100000000 } },
+    { "1970-01-01T00:00:00+14:00", { -50400, 0 } },
+    /* Short fields */
+    { "2001-1-2 3:04:05", { 978404645, 0 } },
+    { "2001-1-2\t\t3:04:05", { 978404645, 0 } },
+    /* Fractions */
+    { "1970-01-01T00:00:00.Z", { 0, 0 } },
+    { "1970-01-01T00:00:00.1234567891Z", { 0, 123456789 } },
+    { "1970-01-01T00:00:00.000000001", { 0, 1 } },
+    { "!!timestamp 2001-12-14", { 1008288000, 0 } },
+    { "!!timestamp '2001-12-14'", { 1008288000, 0 } },
 };
 
-START_TEST(ypbi_invalid)
+START_TEST(ypts_valid)
 {
-    const char *INPUT = INVALID_BINARIES[_i];
+    const char *INPUT = VALID_TIMESTAMPS[_i].input;
     yaml_event_t event;
-    char binary[256];
-    size_t size;
+    struct timespec ts;
 
     yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
                                  strlen(INPUT));
@@ -1728,22 +2278,63 @@ START_TEST(ypbi_invalid)
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
-    errno = 0;
-    ck_assert(!yaml_parse_binary(&event, binary, &size));
-    ck_assert_int_eq(errno, EINVAL);
+    ck_assert(yaml_parse_timestamp(&event, &ts));
+    ck_assert_int_eq(ts.tv_sec, VALID_TIMESTAMPS[_i].ts.tv_sec);
+    ck_assert_int_eq(ts.tv_nsec, VALID_TIMESTAMPS[_i].ts.tv_nsec);
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-START_TEST(ypbi_decoding_error)
+static const char *INVALID_TIMESTAMPS[] = {
+    /* No tag, not plain */
+    "'2001-12-14'",
+    "\"2001-12-14T21:59:43Z\"",
+    /* Bad tag */
+    "!!str 2001-12-14",
+    "!!int 2001-12-14",
+    /* Empty */
+    "!!timestamp",
+    /* Bad date */
+    "2001-12-1",
+    "01-12-14",
+    "2001/12/14",
+    "2001-13-01",
+    "2001-00-01",
+    "2001-12-00",
+    "2001-02-29",
+    "2000-02-30",
+    "1900-02-29",
+    /* Bad time */
+    "2001-12-14T",
+    "2001-12-14X21:59:43",
+    "2001-12-14T24:00:00Z",
+    "2001-12-14T23:60:00Z",
+    "2001-12-14T23:59:61Z",
+    "2001-12-14T23:5:00Z",
+    "2001-12-14T23:59:0Z",
+    "2001-12-14T21:59:43.1.2Z",
+    "2001-12-14T21:59:43.10000000xZ",
+    /* Bad time zone */
+    "2001-12-14T21:59:43ZZ",
+    "2001-12-14T21:59:43+",
+    "2001-12-14T21:59:43+5:3",
+    "2001-12-14T21:59:43+24",
+    "2001-12-14T21:59:43+05:60",
+    "2001-12-14T21:59:43 test",
+    /* Not a timestamp */
+    "~",
+    "test",
+};
+
+START_TEST(ypts_invalid)
 {
-    const unsigned char INPUT[] = "0";
+    const char *INPUT = INVALID_TIMESTAMPS[_i];
     yaml_event_t event;
-    char binary[256];
-    size_t size;
+    struct timespec ts;
 
-    yaml_parser_set_input_string(&parser, INPUT, sizeof(INPUT) - 1);
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
 
     ck_assert(yaml_parser_parse(&parser, &event));
     ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
@@ -1757,29 +2348,1088 @@ START_TEST(ypbi_decoding_error)
     ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
 
     errno = 0;
-    ck_assert(!yaml_parse_binary(&event, binary, &size));
-    ck_assert_int_eq(errno, EILSEQ);
+    ck_assert(!yaml_parse_timestamp(&event, &ts));
+    ck_assert_int_eq(errno, EINVAL);
 
     yaml_event_delete(&event);
 }
 END_TEST
 
-static Suite *
-unit_suite(void)
+/* yaml_emit_timestamp() and yaml_parse_timestamp() agree on every timestamp */
+START_TEST(ypts_round_trip)
 {
-    Suite *suite;
-    TCase *tests;
+    unsigned char input[64 * 1024];
+    struct timespec values[1000];
+    yaml_emitter_t emitter;
+    uint64_t x = 88172645463325252ULL;
+    size_t written = 0;
+    yaml_event_t event;
 
-    suite = suite_create("parse");
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        /* From 0000-01-01 to 9999-12-31 */
+        values[i].tv_sec = (int64_t)(x % 315569520000) - 62167219200;
+        values[i].tv_nsec = i % 2 ? (x >> 40) % 1000000000 : 0;
+        /* Consecutive timestamps of the same day */
+        if (i % 4 == 3)
+            values[i].tv_sec = values[i - 1].tv_sec + 1;
+    }
+
+    ck_assert(yaml_emitter_initialize(&emitter));
+    yaml_emitter_set_output_string(&emitter, input, sizeof(input), &written);
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    ck_assert(yaml_emit_sequence_start(&emitter, NULL));
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++)
+        ck_assert(yaml_emit_timestamp(&emitter, values[i]));
+    ck_assert(yaml_emit_sequence_end(&emitter));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+    yaml_emitter_delete(&emitter);
+
+    yaml_parser_set_input_string(&parser, input, written);
 
-    tests = tcase_create("yaml_mapping_tag");
-    tcase_add_checked_fixture(tests, parser_init, parser_exit);
-    tcase_add_test(tests, ymt_basic);
-    tcase_add_test(tests, ymt_no_tag);
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
 
-    suite_add_tcase(suite, tests);
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
 
-    tests = tcase_create("yaml_scalar_*");
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SEQUENCE_START_EVENT);
+    yaml_event_delete(&event);
+
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        struct timespec ts;
+
+        ck_assert(yaml_parser_parse(&parser, &event));
+        ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+        ck_assert(yaml_parse_timestamp(&event, &ts));
+        ck_assert_int_eq(ts.tv_sec, values[i].tv_sec);
+        ck_assert_int_eq(ts.tv_nsec, values[i].tv_nsec);
+
+        yaml_event_delete(&event);
+    }
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                            yaml_parse_string()                             |
+ *----------------------------------------------------------------------------*/
+
+static const char *ABCDEFGS[] = {
+    "abcdefg",
+    "'abcdefg'",
+    "\"abcdefg\"",
+    "!!str abcdefg",
+    "!!str 'abcdefg'",
+    "!!str \"abcdefg\"",
+};
+
+START_TEST(yps_abcdefg)
+{
+    const char *INPUT = ABCDEFGS[_i];
+    yaml_event_t event;
+    const char *string;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_string(&event, &string, &size));
+    ck_assert_uint_eq(size, strlen(ABCDEFGS[0]));
+    ck_assert_str_eq(string, ABCDEFGS[0]);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/* Any plain scalar can be a string */
+static const char *VALID_STRINGS[] = {
+    "~", /* Null */
+    "y", /* Boolean */
+    "0", /* Integer */
+};
+
+START_TEST(yps_valid_string)
+{
+    const char *INPUT = VALID_STRINGS[_i];
+    yaml_event_t event;
+    const char *string;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_string(&event, &string, &size));
+    ck_assert_uint_eq(size, strlen(INPUT));
+    ck_assert_str_eq(string, INPUT);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(yps_no_size)
+{
+    const unsigned char INPUT[] = "test";
+    yaml_event_t event;
+    const char *string;
+
+    yaml_parser_set_input_string(&parser, INPUT, sizeof(INPUT) - 1);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_string(&event, &string, NULL));
+    ck_assert_str_eq(string, (char *)INPUT);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+static const char *INVALID_STRINGS[] = {
+    /* Bad tag */
+    "!!string test",
+    "!!s test",
+    "!!int test",
+};
+
+START_TEST(yps_invalid_string)
+{
+    const char *INPUT = INVALID_STRINGS[_i];
+    yaml_event_t event;
+    const char *string;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_string(&event, &string, NULL));
+    ck_assert_int_eq(errno, EINVAL);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                            yaml_parse_binary()                             |
+ *----------------------------------------------------------------------------*/
+
+static const char *BINARY_ABCDEFGS[] = {
+    "YWJjZGVmZw==",
+    "!!binary YWJjZGVmZw==",
+    "!!binary 'YWJjZGVmZw=='",
+    "!!binary \"YWJjZGVmZw==\"",
+};
+
+START_TEST(ypbi_abcdefg)
+{
+    const char *INPUT = BINARY_ABCDEFGS[_i];
+    char binary[sizeof(ABCDEFGS[0]) - 1];
+    yaml_event_t event;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_binary(&event, binary, &size));
+    ck_assert_uint_eq(size, sizeof(binary));
+    ck_assert_mem_eq(binary, ABCDEFGS[0], sizeof(binary));
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+static const char *INVALID_BINARIES[] = {
+    /* Not plain */
+    "'AAAA'",
+    /* Bad tag */
+    "!!bin AAAA",
+    "!!str AAAA",
+};
+
+START_TEST(ypbi_invalid)
+{
+    const char *INPUT = INVALID_BINARIES[_i];
+    yaml_event_t event;
+    char binary[256];
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_binary(&event, binary, &size));
+    ck_assert_int_eq(errno, EINVAL);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(ypbi_decoding_error)
+{
+    const unsigned char INPUT[] = "0";
+    yaml_event_t event;
+    char binary[256];
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, INPUT, sizeof(INPUT) - 1);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_binary(&event, binary, &size));
+    ck_assert_int_eq(errno, EILSEQ);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+static const struct {
+    const char *input;
+    bool strict;
+} STRICT_BINARIES[] = {
+    { "YWJjZGVmZw==", true },
+    { "YWJjZGVmZw", true },
+    { "!!binary YWJjZGVmZw ==", true },
+    { "YWJjZGVmZw=", false },
+    { "YWJjZGVmZw===", false },
+    { "!!binary 'YWJjZGVmZw===='", false },
+};
+
+START_TEST(ypbi_strict)
+{
+    const char *INPUT = STRICT_BINARIES[_i].input;
+    char binary[sizeof(ABCDEFGS[0]) - 1];
+    yaml_event_t event;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_binary(&event, binary, &size));
+    ck_assert_uint_eq(size, sizeof(binary));
+    ck_assert_mem_eq(binary, ABCDEFGS[0], sizeof(binary));
+
+    errno = 0;
+    ck_assert(yaml_parse_binary_strict(&event, binary, &size)
+           == STRICT_BINARIES[_i].strict);
+    if (STRICT_BINARIES[_i].strict) {
+        ck_assert_uint_eq(size, sizeof(binary));
+        ck_assert_mem_eq(binary, ABCDEFGS[0], sizeof(binary));
+    } else {
+        ck_assert_int_eq(errno, EILSEQ);
+    }
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(ypbi_size)
+{
+    const char *INPUT = BINARY_ABCDEFGS[_i];
+    yaml_event_t event;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_binary_size(&event, &size));
+    ck_assert_uint_eq(size, sizeof(ABCDEFGS[0]) - 1);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(ypbi_bounded)
+{
+    const char *INPUT = BINARY_ABCDEFGS[_i];
+    char binary[sizeof(ABCDEFGS[0])] = {};
+    yaml_event_t event;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_binary_bounded(&event, binary, sizeof(binary) - 2,
+                                         &size));
+    ck_assert_int_eq(errno, ENOBUFS);
+    ck_assert_int_eq(binary[sizeof(binary) - 2], '\0');
+
+    ck_assert(yaml_parse_binary_bounded(&event, binary, sizeof(binary) - 1,
+                                        &size));
+    ck_assert_uint_eq(size, sizeof(binary) - 1);
+    ck_assert_mem_eq(binary, ABCDEFGS[0], size);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(ypbi_size_invalid)
+{
+    const char *INPUT = INVALID_BINARIES[_i];
+    yaml_event_t event;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_binary_size(&event, &size));
+    ck_assert_int_eq(errno, EINVAL);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(ypbi_inplace)
+{
+    const char *INPUT = BINARY_ABCDEFGS[_i];
+    yaml_event_t event;
+    char *binary;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_binary_inplace(&event, &binary, &size));
+    ck_assert_ptr_eq(binary, yaml_scalar_value(&event));
+    ck_assert_uint_eq(size, sizeof(ABCDEFGS[0]) - 1);
+    ck_assert_mem_eq(binary, ABCDEFGS[0], size);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/* Long enough for the vectorized decoders, with and without line breaks */
+START_TEST(ypbi_inplace_long)
+{
+    unsigned char input[4096];
+    char expected[1000];
+    yaml_emitter_t emitter;
+    size_t written = 0;
+    yaml_event_t event;
+    char *binary;
+    size_t size;
+
+    for (size_t i = 0; i < sizeof(expected); i++)
+        expected[i] = i * 31 + i / 7;
+
+    ck_assert(yaml_emitter_initialize(&emitter));
+    yaml_emitter_set_output_string(&emitter, input, sizeof(input), &written);
+    ck_assert(yaml_emit_stream_start(&emitter, YAML_UTF8_ENCODING));
+    ck_assert(yaml_emit_document_start(&emitter));
+    if (_i)
+        ck_assert(yaml_emit_binary_stream(&emitter, expected,
+                                          sizeof(expected)));
+    else
+        ck_assert(yaml_emit_binary(&emitter, expected, sizeof(expected)));
+    ck_assert(yaml_emit_document_end(&emitter));
+    ck_assert(yaml_emit_stream_end(&emitter));
+    ck_assert(yaml_emitter_flush(&emitter));
+    yaml_emitter_delete(&emitter);
+
+    yaml_parser_set_input_string(&parser, input, written);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_binary_inplace(&event, &binary, &size));
+    ck_assert_uint_eq(size, sizeof(expected));
+    ck_assert_mem_eq(binary, expected, size);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+START_TEST(ypbi_inplace_invalid)
+{
+    const char *INPUT = INVALID_BINARIES[_i];
+    yaml_event_t event;
+    char *binary;
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_binary_inplace(&event, &binary, &size));
+    ck_assert_int_eq(errno, EINVAL);
+    /* The event is left untouched */
+    ck_assert_str_eq(yaml_scalar_value(&event), "AAAA");
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                              yaml_parse_hex()                              |
+ *----------------------------------------------------------------------------*/
+
+static const char *HEX_IDS[] = {
+    "00017f80abff",
+    "00017F80ABFF",
+    "!id 00017f80abff",
+    "!id '00017f80abff'",
+};
+
+START_TEST(yph_id)
+{
+    const char *INPUT = HEX_IDS[_i];
+    yaml_event_t event;
+    char data[6];
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    ck_assert(yaml_parse_hex(&event, "!id", data, sizeof(data), &size));
+    ck_assert_uint_eq(size, sizeof(data));
+    ck_assert_mem_eq(data, "\x00\x01\x7f\x80\xab\xff", sizeof(data));
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+static const struct {
+    const char *input;
+    int error;
+} INVALID_HEXES[] = {
+    /* Not plain */
+    { "'0001'", EINVAL },
+    /* Bad tag */
+    { "!sha1 0001", EINVAL },
+    { "!!str 0001", EINVAL },
+    /* Odd number of digits */
+    { "000", EILSEQ },
+    /* Not a digit */
+    { "000g", EILSEQ },
+    { "00 01", EILSEQ },
+    /* Too long */
+    { "000102030405", ENOBUFS },
+};
+
+START_TEST(yph_invalid)
+{
+    const char *INPUT = INVALID_HEXES[_i].input;
+    yaml_event_t event;
+    char data[4];
+    size_t size;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_hex(&event, "!id", data, sizeof(data), &size));
+    ck_assert_int_eq(errno, INVALID_HEXES[_i].error);
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+static const struct {
+    const char *input;
+    bool valid;
+} HEX_16S[] = {
+    { "000102030405060708090a0b0c0d0e0f", true },
+    { "!fid 000102030405060708090A0B0C0D0E0F", true },
+    { "000102030405060708090a0b0c0d0e", false },
+    { "000102030405060708090a0b0c0d0e0f10", false },
+};
+
+START_TEST(yph_16)
+{
+    const char *INPUT = HEX_16S[_i].input;
+    yaml_event_t event;
+    char data[16];
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(yaml_parse_hex_16(&event, "!fid", data) == HEX_16S[_i].valid);
+    if (HEX_16S[_i].valid) {
+        for (size_t i = 0; i < sizeof(data); i++)
+            ck_assert_int_eq(data[i], i);
+    } else {
+        ck_assert_int_eq(errno, EINVAL);
+    }
+
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                          yaml_parse_scalar_auto()                          |
+ *----------------------------------------------------------------------------*/
+
+#define V11 (1 << YAML_SCHEMA_1_1)
+#define V12 (1 << YAML_SCHEMA_CORE)
+
+static const struct {
+    const char *input;
+    /* Schemas this entry applies to */
+    unsigned int schemas;
+    enum yaml_type type;
+    intmax_t i;
+    double d;
+    const char *string;
+} AUTO_SCALARS[] = {
+    /* Null */
+    { "---", V11 | V12, YT_NULL },
+    { "~", V11 | V12, YT_NULL },
+    { "Null", V11 | V12, YT_NULL },
+    { "!!null whatever", V11 | V12, YT_NULL },
+    /* Boolean */
+    { "true", V11 | V12, YT_BOOL, true },
+    { "FALSE", V11 | V12, YT_BOOL, false },
+    { "Yes", V11, YT_BOOL, true },
+    { "off", V11, YT_BOOL, false },
+    { "Yes", V12, YT_STR, .string = "Yes" },
+    { "off", V12, YT_STR, .string = "off" },
+    { "!!bool y", V11, YT_BOOL, true },
+    /* Integer */
+    { "0", V11 | V12, YT_INT, 0 },
+    { "-0", V11 | V12, YT_INT, 0 },
+    { "42", V11 | V12, YT_INT, 42 },
+    { "-42", V11 | V12, YT_INT, -42 },
+    { "+42", V11 | V12, YT_INT, 42 },
+    { "0x2a", V11 | V12, YT_INT, 42 },
+    { "-0x2a", V11, YT_INT, -42 },
+    { "-0x2a", V12, YT_STR, .string = "-0x2a" },
+    { "0o52", V12, YT_INT, 42 },
+    { "0o52", V11, YT_STR, .string = "0o52" },
+    { "052", V11, YT_INT, 42 },
+    { "052", V12, YT_INT, 52 },
+    { "-052", V12, YT_INT, -52 },
+    { "09", V11, YT_STR, .string = "09" },
+    { "09", V12, YT_INT, 9 },
+    { "0b101010", V11, YT_INT, 42 },
+    { "0b101010", V12, YT_STR, .string = "0b101010" },
+    { "1_000", V11, YT_INT, 1000 },
+    { "1_000", V12, YT_STR, .string = "1_000" },
+    { "9223372036854775807", V11 | V12, YT_INT, INTMAX_MAX },
+    { "-9223372036854775808", V11 | V12, YT_INT, INTMAX_MIN },
+    { "!!int '42'", V11 | V12, YT_INT, 42 },
+    { "!!int 012", V11, YT_INT, 10 },
+    { "!!int 012", V12, YT_INT, 12 },
+    { "!!int -012", V12, YT_INT, -12 },
+    { "!!int 0o12", V12, YT_INT, 10 },
+    { "!!int 0b101", V11, YT_INT, 5 },
+    /* Float */
+    { "1.5", V11 | V12, YT_FLOAT, .d = 1.5 },
+    { "-.5", V11 | V12, YT_FLOAT, .d = -0.5 },
+    { "1.", V11 | V12, YT_FLOAT, .d = 1. },
+    { "1.5e+3", V11 | V12, YT_FLOAT, .d = 1500. },
+    { "1.5e3", V11, YT_STR, .string = "1.5e3" },
+    { "1.5e3", V12, YT_FLOAT, .d = 1500. },
+    { "1e3", V11, YT_STR, .string = "1e3" },
+    { "1e3", V12, YT_FLOAT, .d = 1000. },
+    { "1_000.5", V11, YT_FLOAT, .d = 1000.5 },
+    { "09.5", V11 | V12, YT_FLOAT, .d = 9.5 },
+    { ".inf", V11 | V12, YT_FLOAT, .d = INFINITY },
+    { "-.Inf", V11 | V12, YT_FLOAT, .d = -INFINITY },
+    { ".NaN", V11 | V12, YT_FLOAT, .d = NAN },
+    { ".Nan", V11 | V12, YT_STR, .string = ".Nan" },
+    { "-.nan", V11 | V12, YT_STR, .string = "-.nan" },
+    { "!!float 1", V11 | V12, YT_FLOAT, .d = 1. },
+    /* Timestamp */
+    { "2001-12-14", V11, YT_TIMESTAMP, 1008288000 },
+    { "2001-12-14T21:59:43.10-05:00", V11, YT_TIMESTAMP, 1008385183 },
+    { "2001-12-14", V12, YT_STR, .string = "2001-12-14" },
+    { "2001-13-14", V11, YT_STR, .string = "2001-13-14" },
+    { "!!timestamp 2001-12-14", V11 | V12, YT_TIMESTAMP, 1008288000 },
+    /* String */
+    { "test", V11 | V12, YT_STR, .string = "test" },
+    { "'42'", V11 | V12, YT_STR, .string = "42" },
+    { "\"true\"", V11 | V12, YT_STR, .string = "true" },
+    { "! 42", V11 | V12, YT_STR, .string = "42" },
+    { "!!str 42", V11 | V12, YT_STR, .string = "42" },
+    { "+", V11 | V12, YT_STR, .string = "+" },
+    { ".", V11 | V12, YT_STR, .string = "." },
+    { "+.", V11 | V12, YT_STR, .string = "+." },
+    { "1.2.3", V11 | V12, YT_STR, .string = "1.2.3" },
+    { "1e", V11 | V12, YT_STR, .string = "1e" },
+    { "0x", V11 | V12, YT_STR, .string = "0x" },
+    { "0xg", V11 | V12, YT_STR, .string = "0xg" },
+    { "1:20:30", V11 | V12, YT_STR, .string = "1:20:30" },
+    { "12 monkeys", V11 | V12, YT_STR, .string = "12 monkeys" },
+    { "nullable", V11 | V12, YT_STR, .string = "nullable" },
+};
+
+static void
+check_auto_scalar(size_t index, enum yaml_schema schema)
+{
+    const char *INPUT = AUTO_SCALARS[index].input;
+    struct yaml_scalar scalar;
+    yaml_event_t event;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    /* errno is left untouched on success */
+    errno = ENOENT;
+    ck_assert(yaml_parse_scalar_auto(&event, schema, &scalar));
+    ck_assert_int_eq(errno, ENOENT);
+
+    ck_assert_int_eq(scalar.type, AUTO_SCALARS[index].type);
+    switch (scalar.type) {
+    case YT_BOOL:
+        ck_assert_int_eq(scalar.value.b, AUTO_SCALARS[index].i);
+        break;
+    case YT_INT:
+        ck_assert_int_eq(scalar.value.i, AUTO_SCALARS[index].i);
+        break;
+    case YT_FLOAT:
+        if (isnan(AUTO_SCALARS[index].d))
+            ck_assert(isnan(scalar.value.d));
+        else
+            ck_assert(scalar.value.d == AUTO_SCALARS[index].d);
+        break;
+    case YT_TIMESTAMP:
+        ck_assert_int_eq(scalar.value.ts.tv_sec, AUTO_SCALARS[index].i);
+        break;
+    case YT_STR:
+        ck_assert_uint_eq(scalar.value.string.length,
+                          strlen(AUTO_SCALARS[index].string));
+        ck_assert_str_eq(scalar.value.string.value, AUTO_SCALARS[index].string);
+        break;
+    default:
+        break;
+    }
+
+    yaml_event_delete(&event);
+}
+
+START_TEST(ypsa_1_1)
+{
+    if (AUTO_SCALARS[_i].schemas & V11)
+        check_auto_scalar(_i, YAML_SCHEMA_1_1);
+}
+END_TEST
+
+START_TEST(ypsa_core)
+{
+    if (AUTO_SCALARS[_i].schemas & V12)
+        check_auto_scalar(_i, YAML_SCHEMA_CORE);
+}
+END_TEST
+
+static const struct {
+    const char *input;
+    /* Schemas this entry applies to */
+    unsigned int schemas;
+    int error;
+} INVALID_AUTO_SCALARS[] = {
+    { "!!int foo", V11 | V12, EINVAL },
+    { "!!int 0b101", V12, EINVAL },
+    { "!!int 1_000", V12, EINVAL },
+    { "!!int -0x2a", V12, EINVAL },
+    { "!!bool 1", V11 | V12, EINVAL },
+    { "!!float true", V11 | V12, EINVAL },
+    { "!!timestamp 12", V11 | V12, EINVAL },
+    { "!person john", V11 | V12, ENOTSUP },
+    { "!!binary AAAA", V11 | V12, ENOTSUP },
+    { "!!map foo", V11 | V12, ENOTSUP },
+    { "9223372036854775808", V11 | V12, ERANGE },
+    { "-0x8000000000000001", V11, ERANGE },
+    { "!!int 09223372036854775808", V12, ERANGE },
+    { "1.0e+400", V11 | V12, ERANGE },
+};
+
+static void
+check_invalid_auto_scalar(size_t index, enum yaml_schema schema)
+{
+    const char *INPUT = INVALID_AUTO_SCALARS[index].input;
+    struct yaml_scalar scalar;
+    yaml_event_t event;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_STREAM_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_SCALAR_EVENT);
+
+    errno = 0;
+    ck_assert(!yaml_parse_scalar_auto(&event, schema, &scalar));
+    ck_assert_int_eq(errno, INVALID_AUTO_SCALARS[index].error);
+
+    yaml_event_delete(&event);
+}
+
+START_TEST(ypsa_invalid_1_1)
+{
+    if (INVALID_AUTO_SCALARS[_i].schemas & V11)
+        check_invalid_auto_scalar(_i, YAML_SCHEMA_1_1);
+}
+END_TEST
+
+START_TEST(ypsa_invalid_core)
+{
+    if (INVALID_AUTO_SCALARS[_i].schemas & V12)
+        check_invalid_auto_scalar(_i, YAML_SCHEMA_CORE);
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                              yaml_parse_*_n()                              |
+ *----------------------------------------------------------------------------*/
+
+/* Values are followed by characters that must not be read */
+
+START_TEST(ypnn_null)
+{
+    ck_assert(yaml_parse_null_n("null!", 4, YAML_PLAIN_SCALAR_STYLE, NULL));
+    ck_assert(yaml_parse_null_n("~~", 1, YAML_PLAIN_SCALAR_STYLE, NULL));
+    ck_assert(yaml_parse_null_n("test", 0, YAML_PLAIN_SCALAR_STYLE, NULL));
+    ck_assert(yaml_parse_null_n("test", 4, YAML_PLAIN_SCALAR_STYLE,
+                                "tag:yaml.org,2002:null"));
+
+    errno = 0;
+    ck_assert(!yaml_parse_null_n("nul", 3, YAML_PLAIN_SCALAR_STYLE, NULL));
+    ck_assert_int_eq(errno, EINVAL);
+
+    errno = 0;
+    ck_assert(!yaml_parse_null_n("null", 4, YAML_SINGLE_QUOTED_SCALAR_STYLE,
+                                 NULL));
+    ck_assert_int_eq(errno, EINVAL);
+}
+END_TEST
+
+START_TEST(ypnn_boolean)
+{
+    bool b = false;
+
+    ck_assert(yaml_parse_boolean_n("yesno", 3, YAML_PLAIN_SCALAR_STYLE, NULL,
+                                   &b));
+    ck_assert(b);
+    ck_assert(yaml_parse_boolean_n("nope", 1, YAML_PLAIN_SCALAR_STYLE, NULL,
+                                   &b));
+    ck_assert(!b);
+    ck_assert(yaml_parse_boolean_n("on", 2, YAML_DOUBLE_QUOTED_SCALAR_STYLE,
+                                   "!!bool", &b));
+    ck_assert(b);
+
+    errno = 0;
+    ck_assert(!yaml_parse_boolean_n("true", 3, YAML_PLAIN_SCALAR_STYLE, NULL,
+                                    &b));
+    ck_assert_int_eq(errno, EINVAL);
+
+    errno = 0;
+    ck_assert(!yaml_parse_boolean_n("true", 4, YAML_PLAIN_SCALAR_STYLE,
+                                    "!!str", &b));
+    ck_assert_int_eq(errno, EINVAL);
+}
+END_TEST
+
+START_TEST(ypnn_integer)
+{
+    intmax_t i = 0;
+    uintmax_t u = 0;
+
+    ck_assert(yaml_parse_integer_n("-421", 3, YAML_PLAIN_SCALAR_STYLE, NULL,
+                                   &i));
+    ck_assert_int_eq(i, -42);
+    ck_assert(yaml_parse_integer_n("123456789", 8, YAML_PLAIN_SCALAR_STYLE,
+                                   NULL, &i));
+    ck_assert_int_eq(i, 12345678);
+    ck_assert(yaml_parse_unsigned_integer_n("0x2ag", 4,
+                                            YAML_PLAIN_SCALAR_STYLE, NULL,
+                                            &u));
+    ck_assert_uint_eq(u, 42);
+
+    errno = 0;
+    ck_assert(!yaml_parse_integer_n("-", 1, YAML_PLAIN_SCALAR_STYLE, NULL,
+                                    &i));
+    ck_assert_int_eq(errno, EINVAL);
+
+    errno = 0;
+    ck_assert(!yaml_parse_unsigned_integer_n("42", 2,
+                                             YAML_SINGLE_QUOTED_SCALAR_STYLE,
+                                             NULL, &u));
+    ck_assert_int_eq(errno, EINVAL);
+}
+END_TEST
+
+START_TEST(ypnn_string)
+{
+    const char VALUE[] = "test";
+    const char *string;
+    size_t length;
+
+    ck_assert(yaml_parse_string_n(VALUE, 2, YAML_SINGLE_QUOTED_SCALAR_STYLE,
+                                  NULL, &string, &length));
+    ck_assert_ptr_eq(string, VALUE);
+    ck_assert_uint_eq(length, 2);
+
+    errno = 0;
+    ck_assert(!yaml_parse_string_n(VALUE, 2, YAML_PLAIN_SCALAR_STYLE,
+                                   "!!int", &string, &length));
+    ck_assert_int_eq(errno, EINVAL);
+}
+END_TEST
+
+START_TEST(ypnn_binary)
+{
+    char data[8];
+    size_t size;
+
+    ck_assert(yaml_parse_binary_n("YWJjZGVmZw==!", 12, YAML_PLAIN_SCALAR_STYLE,
+                                  NULL, data, &size));
+    ck_assert_uint_eq(size, 7);
+    ck_assert_mem_eq(data, "abcdefg", size);
+
+    ck_assert(yaml_parse_binary_bounded_n("YWJj!", 4,
+                                          YAML_PLAIN_SCALAR_STYLE, NULL,
+                                          data, 3, &size));
+    ck_assert_uint_eq(size, 3);
+    ck_assert_mem_eq(data, "abc", size);
+
+    errno = 0;
+    ck_assert(!yaml_parse_binary_n("YWJj", 4, YAML_PLAIN_SCALAR_STYLE,
+                                   "!!str", data, &size));
+    ck_assert_int_eq(errno, EINVAL);
+}
+END_TEST
+
+START_TEST(ypnn_tag2type)
+{
+    ck_assert_int_eq(yaml_tag2type_n("tag:yaml.org,2002:intx", 21), YT_INT);
+    ck_assert_int_eq(yaml_tag2type_n("!!strx", 5), YT_STR);
+    ck_assert_int_eq(yaml_tag2type_n("!!timestampx", 11), YT_TIMESTAMP);
+
+    errno = 0;
+    ck_assert_int_eq(yaml_tag2type_n("tag:yaml.org,2002:int", 20),
+                     YT_UNKNOWN);
+    ck_assert_int_eq(errno, EINVAL);
+
+    errno = 0;
+    ck_assert_int_eq(yaml_tag2type_n("!!int", 1), YT_UNKNOWN);
+    ck_assert_int_eq(errno, ENOTSUP);
+}
+END_TEST
+
+static Suite *
+unit_suite(void)
+{
+    Suite *suite;
+    TCase *tests;
+
+    suite = suite_create("parse");
+
+    tests = tcase_create("yaml_mapping_tag");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_test(tests, ymt_basic);
+    tcase_add_test(tests, ymt_no_tag);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_scalar_*");
     tcase_add_checked_fixture(tests, parser_init, parser_exit);
     tcase_add_test(tests, ys_no_tag);
     tcase_add_test(tests, ys_tagged);
@@ -1789,6 +3439,22 @@ unit_suite(void)
 
     suite_add_tcase(suite, tests);
 
+    tests = tcase_create("yaml_scalar_match");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ysm_values, 0, ARRAY_SIZE(SCALAR_MATCHES));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_tag2type");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, yt2t_uri, 0, ARRAY_SIZE(YAML_TYPES));
+    tcase_add_loop_test(tests, yt2t_shorthand, 0, ARRAY_SIZE(YAML_TYPES));
+    tcase_add_test(tests, yt2t_parsed);
+    tcase_add_loop_test(tests, yt2t_unknown, 0, ARRAY_SIZE(UNKNOWN_YAML_TAGS));
+    tcase_add_loop_test(tests, yt2t_local, 0, ARRAY_SIZE(LOCAL_TAGS));
+
+    suite_add_tcase(suite, tests);
+
     tests = tcase_create("yaml_parse_null");
     tcase_add_checked_fixture(tests, parser_init, parser_exit);
     tcase_add_loop_test(tests, ypn_valid, 0, ARRAY_SIZE(VALID_NULLS));
@@ -1817,6 +3483,7 @@ unit_suite(void)
     tcase_add_test(tests, ypi_max_base8);
     tcase_add_test(tests, ypi_max_base16);
     tcase_add_loop_test(tests, ypi_invalid, 0, ARRAY_SIZE(INVALID_INTEGERS));
+    tcase_add_loop_test(tests, ypi_long, 0, ARRAY_SIZE(LONG_INTEGERS));
     tcase_add_test(tests, ypi_too_little_base10);
     tcase_add_test(tests, ypi_too_little_base8);
     tcase_add_test(tests, ypi_too_little_base16);
@@ -1849,6 +3516,34 @@ unit_suite(void)
 
     suite_add_tcase(suite, tests);
 
+    tests = tcase_create("yaml_parse_int*");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ypfwi_values, 0,
+                        ARRAY_SIZE(FIXED_WIDTH_INTEGERS));
+    tcase_add_loop_test(tests, ypfwu_values, 0,
+                        ARRAY_SIZE(FIXED_WIDTH_UNSIGNED_INTEGERS));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parse_float");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ypf_valid, 0, ARRAY_SIZE(VALID_FLOATS));
+    tcase_add_loop_test(tests, ypf_invalid, 0, ARRAY_SIZE(INVALID_FLOATS));
+    tcase_add_loop_test(tests, ypf_out_of_range, 0,
+                        ARRAY_SIZE(OUT_OF_RANGE_FLOATS));
+    tcase_add_test(tests, ypf_round_trip);
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parse_timestamp");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ypts_valid, 0, ARRAY_SIZE(VALID_TIMESTAMPS));
+    tcase_add_loop_test(tests, ypts_invalid, 0,
+                        ARRAY_SIZE(INVALID_TIMESTAMPS));
+    tcase_add_test(tests, ypts_round_trip);
+
+    suite_add_tcase(suite, tests);
+
     tests = tcase_create("yaml_parse_string");
     tcase_add_checked_fixture(tests, parser_init, parser_exit);
     tcase_add_loop_test(tests, yps_abcdefg, 0, ARRAY_SIZE(ABCDEFGS));
@@ -1864,6 +3559,44 @@ unit_suite(void)
     tcase_add_loop_test(tests, ypbi_abcdefg, 0, ARRAY_SIZE(BINARY_ABCDEFGS));
     tcase_add_loop_test(tests, ypbi_invalid, 0, ARRAY_SIZE(INVALID_BINARIES));
     tcase_add_test(tests, ypbi_decoding_error);
+    tcase_add_loop_test(tests, ypbi_strict, 0, ARRAY_SIZE(STRICT_BINARIES));
+    tcase_add_loop_test(tests, ypbi_size, 0, ARRAY_SIZE(BINARY_ABCDEFGS));
+    tcase_add_loop_test(tests, ypbi_size_invalid, 0,
+                        ARRAY_SIZE(INVALID_BINARIES));
+    tcase_add_loop_test(tests, ypbi_bounded, 0, ARRAY_SIZE(BINARY_ABCDEFGS));
+    tcase_add_loop_test(tests, ypbi_inplace, 0, ARRAY_SIZE(BINARY_ABCDEFGS));
+    tcase_add_loop_test(tests, ypbi_inplace_long, 0, 2);
+    tcase_add_loop_test(tests, ypbi_inplace_invalid, 0,
+                        ARRAY_SIZE(INVALID_BINARIES));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parse_hex");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, yph_id, 0, ARRAY_SIZE(HEX_IDS));
+    tcase_add_loop_test(tests, yph_invalid, 0, ARRAY_SIZE(INVALID_HEXES));
+    tcase_add_loop_test(tests, yph_16, 0, ARRAY_SIZE(HEX_16S));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parse_scalar_auto");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ypsa_1_1, 0, ARRAY_SIZE(AUTO_SCALARS));
+    tcase_add_loop_test(tests, ypsa_core, 0, ARRAY_SIZE(AUTO_SCALARS));
+    tcase_add_loop_test(tests, ypsa_invalid_1_1, 0,
+                        ARRAY_SIZE(INVALID_AUTO_SCALARS));
+    tcase_add_loop_test(tests, ypsa_invalid_core, 0,
+                        ARRAY_SIZE(INVALID_AUTO_SCALARS));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parse_*_n");
+    tcase_add_test(tests, ypnn_null);
+    tcase_add_test(tests, ypnn_boolean);
+    tcase_add_test(tests, ypnn_integer);
+    tcase_add_test(tests, ypnn_string);
+    tcase_add_test(tests, ypnn_binary);
+    tcase_add_test(tests, ypnn_tag2type);
 
     suite_add_tcase(suite, tests);
 
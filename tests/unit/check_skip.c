@@ -9,6 +9,9 @@
 # include "config.h"
 #endif
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <check.h>
 
 #include <miniyaml.h>
@@ -399,6 +402,219 @@ START_TEST(yps_error)
 }
 END_TEST
 
+static const char *INVALID_DOCUMENTS[] = {
+    "--- 'foo\n--- bar'\n",
+    "--- [\n---\n]\n",
+};
+
+START_TEST(yps_document_error)
+{
+    const char *INPUT = INVALID_DOCUMENTS[_i];
+    yaml_event_t event;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    skip_stream_start(&parser);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    ck_assert(!yaml_parser_skip(&parser, YAML_DOCUMENT_START_EVENT));
+}
+END_TEST
+
+/*----------------------------------------------------------------------------*
+ |                   yaml_parser_skip_document_unchecked()                    |
+ *----------------------------------------------------------------------------*/
+
+/* Whether documents read from strings are skipped without being parsed */
+static bool
+skips_unchecked(void)
+{
+    int major, minor, patch;
+
+    yaml_get_version(&major, &minor, &patch);
+    return major == 0 && minor == 2 && patch == 5;
+}
+
+/* Documents skipped from strings are compared to the same documents skipped
+ * from a reader libyaml knows nothing about, which goes event by event
+ */
+struct chunk {
+    const unsigned char *current;
+    const unsigned char *end;
+};
+
+static int
+read_chunk(void *data, unsigned char *buffer, size_t size, size_t *size_read)
+{
+    struct chunk *chunk = data;
+
+    if (size > (size_t)(chunk->end - chunk->current))
+        size = chunk->end - chunk->current;
+
+    memcpy(buffer, chunk->current, size);
+    chunk->current += size;
+    *size_read = size;
+    return 1;
+}
+
+static void
+ck_assert_mark_eq(yaml_mark_t x, yaml_mark_t y)
+{
+    ck_assert_uint_eq(x.index, y.index);
+    ck_assert_uint_eq(x.line, y.line);
+    ck_assert_uint_eq(x.column, y.column);
+}
+
+static void
+ck_assert_skip_document(const unsigned char *input, size_t length)
+{
+    struct chunk chunk = {
+        .current = input,
+        .end = input + length,
+    };
+    yaml_parser_t reference;
+    yaml_event_type_t type;
+    size_t documents = 0;
+
+    ck_assert(yaml_parser_initialize(&reference));
+    yaml_parser_set_encoding(&reference, YAML_UTF8_ENCODING);
+    yaml_parser_set_input(&reference, read_chunk, &chunk);
+    yaml_parser_set_input_string(&parser, input, length);
+
+    skip_stream_start(&parser);
+    skip_stream_start(&reference);
+
+    do {
+        yaml_event_t expected;
+        yaml_event_t event;
+        bool success;
+
+        success = yaml_parser_parse(&reference, &expected);
+        ck_assert(yaml_parser_parse(&parser, &event) == success);
+        if (!success)
+            break;
+
+        ck_assert_int_eq(event.type, expected.type);
+        ck_assert_mark_eq(event.start_mark, expected.start_mark);
+        ck_assert_mark_eq(event.end_mark, expected.end_mark);
+        if (event.type == YAML_SCALAR_EVENT)
+            ck_assert_str_eq((char *)event.data.scalar.value,
+                             (char *)expected.data.scalar.value);
+
+        type = event.type;
+        yaml_event_delete(&expected);
+        yaml_event_delete(&event);
+
+        /* Skip the first document, and every other one after that */
+        if (type == YAML_DOCUMENT_START_EVENT && documents++ % 2 == 0) {
+            success = yaml_parser_skip(&reference, type);
+            ck_assert(yaml_parser_skip_document_unchecked(&parser)
+                      == success);
+            if (!success)
+                break;
+        }
+    } while (type != YAML_STREAM_END_EVENT);
+
+    yaml_parser_delete(&reference);
+}
+
+static const char *SKIPPED_DOCUMENTS[] = {
+    "---\nfoo: bar\n---\nbaz\n",
+    "--- foo\n...\n--- bar\n...\n--- baz\n",
+    "--- foo\n---\tbar\n--- \n",
+    "---",
+    "---\n",
+    "--- [a, b, c]",
+    "---\n{a: b}\n\n# comment\n--- c\n",
+    /* Markers that are not at the start of a line */
+    "---\n|\n  ---\n  ...\n---\n- a\n",
+    "---\nkey:\n  - ---\n  - ...\n--- value",
+    /* Not markers */
+    "---\n----\n---x\n...x\n... \n---\nend",
+    /* Line breaks */
+    "---\r\nkey: \"\xc3\xa9t\xc3\xa9\"\r\n---\r\nnext\r\n",
+    "---\rfoo\r---\rbar",
+    "---\nfoo\xe2\x80\xa8---\nbar\n",
+    "---\nfoo\xc2\x85...\n--- bar",
+    /* Implicit document */
+    "foo\n---\nbar",
+    /* Directives do not outlive a document */
+    "%TAG !e! tag:example.com,2019:\n--- !e!foo\nx\n...\n--- !e!bar y\n",
+    "%TAG !e! tag:example.com,2019:\n--- !e!foo\nx\n...\n"
+    "%TAG !e! tag:example.com,2019:\n--- !e!bar y\n",
+};
+
+START_TEST(ypsdu_basic)
+{
+    const char *INPUT = SKIPPED_DOCUMENTS[_i];
+
+    ck_assert_skip_document((const unsigned char *)INPUT, strlen(INPUT));
+}
+END_TEST
+
+START_TEST(ypsdu_invalid)
+{
+    const char *INPUT = INVALID_DOCUMENTS[_i];
+    yaml_event_t event;
+
+    yaml_parser_set_input_string(&parser, (const unsigned char *)INPUT,
+                                 strlen(INPUT));
+
+    skip_stream_start(&parser);
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    yaml_event_delete(&event);
+
+    if (!skips_unchecked()) {
+        /* Documents are parsed with other releases of libyaml */
+        ck_assert(!yaml_parser_skip_document_unchecked(&parser));
+        return;
+    }
+
+    /* The content of skipped documents is not checked for errors */
+    ck_assert(yaml_parser_skip_document_unchecked(&parser));
+
+    ck_assert(yaml_parser_parse(&parser, &event));
+    ck_assert_int_eq(event.type, YAML_DOCUMENT_START_EVENT);
+    ck_assert_uint_eq(event.start_mark.line, 1);
+    yaml_event_delete(&event);
+}
+END_TEST
+
+/* Larger than libyaml's buffers */
+START_TEST(ypsdu_long)
+{
+    const char ITEM[] = "- \xc3\xa9l\xc3\xa9ment\n";
+    const char TAIL[] = "---\nend\n";
+    const size_t COUNT = 1 << 16;
+    unsigned char *input;
+    size_t length = 0;
+
+    input = malloc(2 * 4 + COUNT * (sizeof(ITEM) - 1) + sizeof(TAIL));
+    ck_assert_ptr_nonnull(input);
+
+    for (int i = 0; i < 2; i++) {
+        memcpy(input + length, "---\n", 4);
+        length += 4;
+        for (size_t j = 0; j < COUNT / 2; j++) {
+            memcpy(input + length, ITEM, sizeof(ITEM) - 1);
+            length += sizeof(ITEM) - 1;
+        }
+    }
+    memcpy(input + length, TAIL, sizeof(TAIL) - 1);
+    length += sizeof(TAIL) - 1;
+
+    ck_assert_skip_document(input, length);
+
+    free(input);
+}
+END_TEST
+
 /*----------------------------------------------------------------------------*
  |                          yaml_parser_skip_next()                           |
  *----------------------------------------------------------------------------*/
@@ -439,6 +655,98 @@ START_TEST(ypsn_error)
 }
 END_TEST
 
+/*----------------------------------------------------------------------------*
+ |                           yaml_index_documents()                           |
+ *----------------------------------------------------------------------------*/
+
+static const struct {
+    const char *input;
+    size_t count;
+    struct {
+        size_t offset;
+        size_t line;
+        const char *tag;
+    } documents[3];
+} INDEXED_STREAMS[] = {
+    { "", 0, },
+    { "# comment\n\n", 0, },
+    { "foo", 1, {{ 0, 0, NULL }}},
+    { "--- !entry\na: 1\n--- !entry\na: 2\n", 2, {
+        { 0, 0, "!entry" },
+        { 16, 2, "!entry" },
+    }},
+    { "# header\n--- &a !!map {}\n...\n# comment\n%YAML 1.1\n--- !e x\n", 2, {
+        { 0, 0, "!!map" },
+        { 29, 3, "!e" },
+    }},
+    { "a\n--- b\n...\n...\n", 2, {
+        { 0, 0, NULL },
+        { 2, 1, NULL },
+    }},
+    { "--- |\n  ---\n  ...\n--- >\n text\n--- #!comment\n", 3, {
+        { 0, 0, NULL },
+        { 18, 3, NULL },
+        { 30, 5, NULL },
+    }},
+    { "---x\n--- !<tag:example.com,2019:y> y", 2, {
+        { 0, 0, NULL },
+        { 5, 1, "!<tag:example.com,2019:y>" },
+    }},
+    { "\xef\xbb\xbf--- !bom\n", 1, {{ 0, 0, "!bom" }}},
+    { "--- !a\r\nx\r\n--- !b\r\n", 2, {
+        { 0, 0, "!a" },
+        { 11, 2, "!b" },
+    }},
+};
+
+START_TEST(yid_streams)
+{
+    const char *INPUT = INDEXED_STREAMS[_i].input;
+    const size_t LENGTH = strlen(INPUT);
+    struct yaml_document_offset *documents;
+    size_t count;
+
+    ck_assert(yaml_index_documents(INPUT, LENGTH, &documents, &count));
+    ck_assert_uint_eq(count, INDEXED_STREAMS[_i].count);
+
+    for (size_t i = 0; i < count; i++) {
+        const char *TAG = INDEXED_STREAMS[_i].documents[i].tag;
+        const size_t offset = documents[i].offset;
+        size_t end = i + 1 < count ? documents[i + 1].offset : LENGTH;
+        yaml_event_type_t type;
+        size_t starts = 0;
+        yaml_event_t event;
+
+        ck_assert_uint_eq(offset, INDEXED_STREAMS[_i].documents[i].offset);
+        ck_assert_uint_eq(documents[i].line,
+                          INDEXED_STREAMS[_i].documents[i].line);
+        if (TAG) {
+            ck_assert_uint_eq(documents[i].tag_length, strlen(TAG));
+            ck_assert_mem_eq(INPUT + offset + documents[i].tag_offset, TAG,
+                             strlen(TAG));
+        } else {
+            ck_assert_uint_eq(documents[i].tag_length, 0);
+        }
+
+        /* Each slice holds exactly one document */
+        yaml_parser_delete(&parser);
+        parser_init();
+        yaml_parser_set_input_string(&parser,
+                                     (const unsigned char *)INPUT + offset,
+                                     end - offset);
+        do {
+            ck_assert(yaml_parser_parse(&parser, &event));
+            starts += event.type == YAML_DOCUMENT_START_EVENT;
+            type = event.type;
+            yaml_event_delete(&event);
+        } while (type != YAML_STREAM_END_EVENT);
+        ck_assert_uint_eq(starts, 1);
+    }
+
+    free(documents);
+}
+END_TEST
+
 static Suite *
 unit_suite(void)
 {
@@ -463,6 +771,17 @@ unit_suite(void)
     tcase_add_test(tests, yps_mapping_in_sequence);
     tcase_add_test(tests, yps_sequence_in_mapping);
     tcase_add_test(tests, yps_error);
+    tcase_add_loop_test(tests, yps_document_error, 0,
+                        ARRAY_SIZE(INVALID_DOCUMENTS));
+
+    suite_add_tcase(suite, tests);
+
+    tests = tcase_create("yaml_parser_skip_document_unchecked");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, ypsdu_basic, 0, ARRAY_SIZE(SKIPPED_DOCUMENTS));
+    tcase_add_loop_test(tests, ypsdu_invalid, 0,
+                        ARRAY_SIZE(INVALID_DOCUMENTS));
+    tcase_add_test(tests, ypsdu_long);
 
     suite_add_tcase(suite, tests);
 
@@ -473,6 +792,12 @@ unit_suite(void)
 
     suite_add_tcase(suite, tests);
 
+    tests = tcase_create("yaml_index_documents");
+    tcase_add_checked_fixture(tests, parser_init, parser_exit);
+    tcase_add_loop_test(tests, yid_streams, 0, ARRAY_SIZE(INDEXED_STREAMS));
+
+    suite_add_tcase(suite, tests);
+
     return suite;
 }
 